@@ -0,0 +1,173 @@
+#include "Baseline.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Bench;
+
+namespace {
+
+// Fraction by which a counter may exceed its recorded value before failing.
+constexpr double Headroom = 0.05;
+
+} // namespace
+
+void CoroGLL::Bench::Accumulate(ParseStats& total, const ParseStats& stats)
+{
+	total.tokens += stats.tokens;
+	total.steps += stats.steps;
+	total.frames += stats.frames;
+	total.memoHits += stats.memoHits;
+	total.forks += stats.forks;
+	total.forksTerminated += stats.forksTerminated;
+	total.forkBytesCopied += stats.forkBytesCopied;
+	total.treeBytes += stats.treeBytes;
+	total.treeAllocations += stats.treeAllocations;
+	total.lexNanoseconds += stats.lexNanoseconds;
+	total.matchNanoseconds += stats.matchNanoseconds;
+	total.parseNanoseconds += stats.parseNanoseconds;
+	total.peakLiveForks = std::max(total.peakLiveForks, stats.peakLiveForks);
+	total.peakCoroutineBytes = std::max(total.peakCoroutineBytes, stats.peakCoroutineBytes);
+}
+
+std::string CoroGLL::Bench::GetBuildToolchain()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	std::string compiler = "msvc-" + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+	std::string compiler = "clang-" + std::to_string(__clang_major__) + '.' + std::to_string(__clang_minor__) + '.' + std::to_string(__clang_patchlevel__);
+#elif defined(__GNUC__)
+	std::string compiler = "gcc-" + std::to_string(__GNUC__) + '.' + std::to_string(__GNUC_MINOR__) + '.' + std::to_string(__GNUC_PATCHLEVEL__);
+#else
+	std::string compiler = "unknown";
+#endif
+
+	return compiler + '-' + std::to_string(sizeof(void*) * 8) + "bit";
+}
+
+bool Baseline::Read(std::istream& is)
+{
+	for (std::string line; std::getline(is, line);)
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+
+		std::string configuration;
+		if (!(fields >> configuration))
+			return false;
+
+		if (configuration == "toolchain")
+		{
+			if (!(fields >> m_toolchain))
+				return false;
+			continue;
+		}
+
+		std::string counter;
+		u64 value;
+
+		if (!(fields >> counter >> value))
+			return false;
+
+		m_counters[configuration][counter] = value;
+	}
+	return !is.bad();
+}
+
+void Baseline::Write(std::ostream& os) const
+{
+	if (!m_toolchain.empty())
+		os << "toolchain " << m_toolchain << '\n';
+
+	for (const auto& [configuration, counters] : m_counters)
+	{
+		for (const auto& [counter, value] : counters)
+			os << configuration << ' ' << counter << ' ' << value << '\n';
+	}
+}
+
+void Baseline::SetToolchain(std::string toolchain)
+{
+	m_toolchain = std::move(toolchain);
+}
+
+void Baseline::Set(std::string_view configuration, const ParseStats& stats)
+{
+	std::map<std::string, u64>& counters = m_counters[std::string(configuration)];
+
+#define COROGLL_X(n) counters[#n] = stats.n;
+	COROGLL_BASELINE_COUNTER(COROGLL_X)
+
+	if (!m_toolchain.empty())
+	{
+		COROGLL_BASELINE_BYTE_COUNTER(COROGLL_X)
+	}
+#undef COROGLL_X
+}
+
+bool Baseline::Check(std::string_view configuration, const ParseStats& stats, std::ostream& os) const
+{
+	auto it = m_counters.find(configuration);
+	if (it == m_counters.end())
+	{
+		os << configuration << ": no recorded counters\n";
+		return false;
+	}
+
+	const std::map<std::string, u64>& counters = it->second;
+	bool success = true;
+
+	auto find = [&](const char* counter) -> const u64*
+	{
+		auto recorded = counters.find(counter);
+		if (recorded == counters.end())
+		{
+			os << configuration << ' ' << counter << ": not recorded\n";
+			success = false;
+			return nullptr;
+		}
+		return &recorded->second;
+	};
+
+	auto check = [&](const char* counter, auto value, auto recorded)
+	{
+		if (value > recorded * (1 + Headroom))
+		{
+			os << configuration << ' ' << counter << ": " << value << " exceeds " << recorded << '\n';
+			success = false;
+		}
+		else if (value < recorded)
+		{
+			//not a failure, but the baseline should be recorded again to catch regressions up to it
+			os << configuration << ' ' << counter << ": " << value << " below " << recorded << '\n';
+		}
+	};
+
+#define COROGLL_X(n) if (const u64* recorded = find(#n)) check(#n, stats.n, *recorded);
+	COROGLL_BASELINE_COUNTER(COROGLL_X)
+
+	if (m_toolchain.empty())
+	{
+		//the byte counters were not recorded
+	}
+	else if (m_toolchain == GetBuildToolchain())
+	{
+		COROGLL_BASELINE_BYTE_COUNTER(COROGLL_X)
+	}
+	else
+	{
+		const u64* copied = find("forkBytesCopied");
+		const u64* peak = find("peakCoroutineBytes");
+
+		if (copied != nullptr && peak != nullptr && *peak != 0 && stats.peakCoroutineBytes != 0)
+			check("forkBytesCopied/peakCoroutineBytes", (double)stats.forkBytesCopied / stats.peakCoroutineBytes, (double)*copied / *peak);
+	}
+#undef COROGLL_X
+
+	return success;
+}
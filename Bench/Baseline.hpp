@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ParseStats.hpp"
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Counters of ParseStats which depend only on the input and the engine, not on timing.
+#define COROGLL_BASELINE_COUNTER(X) \
+	X( steps              ) \
+	X( frames             ) \
+	X( memoHits           ) \
+	X( forks              ) \
+	X( forksTerminated    ) \
+	X( peakLiveForks      ) \
+	X( treeAllocations    ) \
+
+// Deterministic counters of bytes, which also depend on the layouts chosen by the compiler.
+#define COROGLL_BASELINE_BYTE_COUNTER(X) \
+	X( forkBytesCopied    ) \
+	X( peakCoroutineBytes ) \
+	X( treeBytes          ) \
+
+// Set to one to record byte counters in the baseline. They are only recorded
+// by MSVC by default, the compiler the engine targets, as the layouts chosen
+// by another would give values which do not hold for it.
+#ifndef COROGLL_BASELINE_BYTES
+#	if defined(_MSC_VER) && !defined(__clang__)
+#		define COROGLL_BASELINE_BYTES 1
+#	else
+#		define COROGLL_BASELINE_BYTES 0
+#	endif
+#endif
+
+namespace CoroGLL::Bench {
+
+inline constexpr bool RecordBaselineBytes = COROGLL_BASELINE_BYTES != 0;
+
+// Adds the counters of one parse to a total. Peaks take the maximum.
+void Accumulate(ParseStats& total, const ParseStats& stats);
+
+// Names the compiler and pointer width of this build, which decide the byte counters.
+std::string GetBuildToolchain();
+
+// Recorded deterministic counters of each engine configuration. A counter
+// fails its check once it exceeds the recorded value by more than a small
+// headroom. The file holds one "<configuration> <counter> <value>" per line;
+// lines starting with # are comments.
+// Byte counters are only present when the file names the toolchain which
+// recorded them on a "toolchain <name>" line. They are checked against their
+// values only under that toolchain. Under another, the fork bytes copied are
+// checked relative to the peak coroutine bytes instead, as both scale with the
+// coroutine frame layout. Without a toolchain, byte counters are not checked.
+class Baseline
+{
+public:
+	bool Read(std::istream& is);
+	void Write(std::ostream& os) const;
+
+	const std::string& GetToolchain() const
+	{
+		return m_toolchain;
+	}
+
+	// Byte counters are set along with the others once a toolchain is set.
+	void SetToolchain(std::string toolchain);
+	void Set(std::string_view configuration, const ParseStats& stats);
+
+	// Reports each counter exceeding its recorded value, or lacking one, to os.
+	// Returns whether all counters are within their headroom.
+	bool Check(std::string_view configuration, const ParseStats& stats, std::ostream& os) const;
+
+private:
+	std::string m_toolchain;
+
+	//keyed by configuration, then counter
+	std::map<std::string, std::map<std::string, u64>, std::less<>> m_counters;
+};
+
+} // namespace CoroGLL::Bench
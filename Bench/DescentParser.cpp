@@ -0,0 +1,758 @@
+#include "DescentParser.hpp"
+
+#include "Lexer.hpp"
+#include "OperatorTable.hpp"
+#include "Core/Debug.hpp"
+#include "Syntax/Expression.hpp"
+#include "Syntax/SyntaxKindSet.hpp"
+
+#include <vector>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Ast;
+
+namespace {
+
+// tokens which may begin an operand. mirrors the sets of the grammar.
+constexpr SyntaxKindSet FirstOfTypeExpression = SyntaxKindSet{
+#define COROGLL_X(n, s) SyntaxKind::n ## Keyword,
+	COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+	SyntaxKind::NameToken,
+	SyntaxKind::ScopeSymbol,
+	SyntaxKind::CharLiteralToken,
+	SyntaxKind::StringLiteralToken,
+	SyntaxKind::NumericLiteralToken,
+	SyntaxKind::DollarSymbol,
+};
+
+constexpr SyntaxKindSet FirstOfUnaryPrefixOperator = {
+	SyntaxKind::AddSymbol,
+	SyntaxKind::AndSymbol,
+	SyntaxKind::AwaitKeyword,
+	SyntaxKind::DecrementSymbol,
+	SyntaxKind::MulSymbol,
+	SyntaxKind::NotSymbol,
+	SyntaxKind::IncrementSymbol,
+	SyntaxKind::LogicalNotSymbol,
+	SyntaxKind::SubSymbol,
+};
+
+constexpr SyntaxKindSet FirstOfUnaryExpression = FirstOfTypeExpression | SyntaxKindSet{ SyntaxKind::LParenSymbol } | FirstOfUnaryPrefixOperator;
+constexpr SyntaxKindSet FirstOfUnaryTypeExpression = FirstOfTypeExpression | FirstOfUnaryPrefixOperator;
+
+// tokens after a specialization which reject it.
+constexpr SyntaxKindSet FollowRejectingSpecialization = SyntaxKindSet{
+#define COROGLL_X(n, s) SyntaxKind::n ## Keyword,
+	COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+	SyntaxKind::NameToken,
+	SyntaxKind::LParenSymbol,
+	SyntaxKind::CharLiteralToken,
+	SyntaxKind::StringLiteralToken,
+	SyntaxKind::NumericLiteralToken,
+	SyntaxKind::DollarSymbol,
+};
+
+bool IsWordToken(SyntaxKind syntaxKind)
+{
+	switch (syntaxKind)
+	{
+	COROGLL_CASE_SYNTAXKIND_KEYWORD
+	case SyntaxKind::NameToken:
+		return true;
+	}
+	return false;
+}
+
+bool IsTypeExpression(Expression* expression)
+{
+	switch (expression->Kind())
+	{
+	case SyntaxKind::MetaExpression:
+	case SyntaxKind::WordExpression:
+	case SyntaxKind::ScopeAccessExpression:
+	case SyntaxKind::SpecializationExpression:
+		return true;
+	}
+	return false;
+}
+
+// Each rule returns false when it fails, leaving the position unspecified.
+// Results are returned through out parameters, as a rule may succeed with null.
+class DescentParser
+{
+public:
+	DescentParser(Span<Token*> tokens, Span<const i32> brackets, Private::SyntaxTreeContext* treeContext, const ParseOptions& options)
+		: m_tokens(tokens), m_brackets(brackets), m_treeContext(treeContext), m_options(&options)
+	{
+	}
+
+	bool ParseRoot(Expression*& out)
+	{
+		return ParseExpression(false, Precedence::Expression, out)
+			&& PeekToken()->Kind() == SyntaxKind::EofToken;
+	}
+
+private:
+	Token* PeekToken(i32 index = 0)
+	{
+		Assert(m_tokenIndex + index < m_tokens.Size());
+		return m_tokens[m_tokenIndex + index];
+	}
+
+	Token* EatToken()
+	{
+		Assert(m_tokenIndex < m_tokens.Size());
+		return m_tokens[m_tokenIndex++];
+	}
+
+	i32 PeekMatchingToken(i32 index = 0)
+	{
+		return m_brackets[m_tokenIndex + index] - m_tokenIndex;
+	}
+
+	template<typename T, typename... TArgs>
+	T* CreateSyntax(TArgs&&... args)
+	{
+		return m_treeContext->CreateSyntax<T>(std::forward<TArgs>(args)...);
+	}
+
+	NameKind ClassifyName(WordToken* nameToken)
+	{
+		if (NameOracle* oracle = m_options->nameOracle)
+			return oracle->Classify(nameToken);
+		return NameKind::Unknown;
+	}
+
+	NameKind ClassifyName(Expression* expression)
+	{
+		if (expression->Kind() != SyntaxKind::WordExpression)
+			return NameKind::Unknown;
+		return ClassifyName(static_cast<WordExpression*>(expression)->nameToken);
+	}
+
+	NameKind ClassifyParenthesizedName()
+	{
+		if (!IsWordToken(PeekToken(1)->Kind()) || PeekToken(2)->Kind() != SyntaxKind::RParenSymbol)
+			return NameKind::Unknown;
+		return ClassifyName(static_cast<WordToken*>(PeekToken(1)));
+	}
+
+	OperatorInfo PeekBinaryOperator(i32* tokenCount)
+	{
+		const OperatorTable& operatorTable = *m_options->operatorTable;
+
+		Token* operatorToken = PeekToken();
+		OperatorInfo operatorInfo = operatorTable.Lookup(operatorToken->Kind());
+		*tokenCount = 1;
+
+		if (operatorToken->Kind() != SyntaxKind::GreaterSymbol || operatorToken->TrailingTrivia().Size() != 0)
+			return operatorInfo;
+
+		Token* operatorToken2 = PeekToken(1);
+		if (operatorToken2->LeadingTrivia().Size() != 0)
+			return operatorInfo;
+
+		OperatorInfo combinedInfo;
+		switch (operatorToken2->Kind())
+		{
+		case SyntaxKind::GreaterSymbol:
+			if (operatorToken2->TrailingTrivia().Size() == 0)
+			{
+				Token* operatorToken3 = PeekToken(2);
+				if (operatorToken3->Kind() == SyntaxKind::AssignSymbol && operatorToken3->LeadingTrivia().Size() == 0)
+				{
+					combinedInfo = operatorTable.Lookup(CombinedSymbol::AssignRhs);
+					if (combinedInfo.IsBinaryOperator())
+					{
+						*tokenCount = 3;
+						return combinedInfo;
+					}
+				}
+			}
+			combinedInfo = operatorTable.Lookup(CombinedSymbol::RightShift);
+			break;
+
+		case SyntaxKind::AssignSymbol:
+			combinedInfo = operatorTable.Lookup(CombinedSymbol::GreaterOrEqual);
+			break;
+
+		default:
+			return operatorInfo;
+		}
+
+		if (combinedInfo.IsBinaryOperator())
+		{
+			*tokenCount = 2;
+			return combinedInfo;
+		}
+
+		return operatorInfo;
+	}
+
+	bool ParseArgument(bool typeExpr, Argument*& out)
+	{
+		WordToken* nameToken = nullptr;
+		Token* colonToken = nullptr;
+
+		if (IsWordToken(PeekToken()->Kind()) && PeekToken(1)->Kind() == SyntaxKind::ColonSymbol)
+		{
+			nameToken = static_cast<WordToken*>(EatToken());
+			colonToken = EatToken();
+		}
+
+		Expression* expression;
+		if (!ParseExpression(typeExpr, Precedence::Expression, expression))
+			return false;
+
+		out = CreateSyntax<Argument>(nameToken, colonToken, expression);
+		return true;
+	}
+
+	bool ParseArgumentList(bool typeExpr, ArgumentList*& out)
+	{
+		std::vector<Argument*> arguments;
+
+		switch (PeekToken()->Kind())
+		{
+		case SyntaxKind::RParenSymbol:
+		case SyntaxKind::RBrackSymbol:
+		case SyntaxKind::RAngleSymbol:
+			break;
+
+		default:
+			do
+			{
+				if (!arguments.empty())
+					EatToken();
+
+				Argument* argument;
+				if (!ParseArgument(typeExpr, argument))
+					return false;
+				arguments.push_back(argument);
+			} while (PeekToken()->Kind() == SyntaxKind::CommaSymbol);
+		}
+
+		out = CreateSyntax<ArgumentList>(m_treeContext->CreateSyntaxList<Argument>(arguments.begin(), arguments.end()));
+		return true;
+	}
+
+	bool ParseParensExpression(Expression*& out)
+	{
+		Token* openToken = EatToken();
+
+		Expression* expression;
+		if (!ParseExpression(false, Precedence::Expression, expression))
+			return false;
+
+		if (PeekToken()->Kind() != SyntaxKind::RParenSymbol)
+			return false;
+		Token* closeToken = EatToken();
+
+		out = CreateSyntax<ParenthesizedExpression>(openToken, expression, closeToken);
+		return true;
+	}
+
+	bool ParseCastExpression(Expression*& out)
+	{
+		Token* openToken = EatToken();
+
+		Expression* typeExpression;
+		if (!ParseExpression(true, Precedence::Expression, typeExpression))
+			return false;
+
+		if (PeekToken()->Kind() != SyntaxKind::RParenSymbol)
+			return false;
+		Token* closeToken = EatToken();
+
+		Expression* expression;
+		if (!ParseExpression(false, Precedence::TypeCast, expression))
+			return false;
+
+		out = CreateSyntax<CastExpression>(openToken, typeExpression, closeToken, expression);
+		return true;
+	}
+
+	bool PeekCastExpression()
+	{
+		if (!FirstOfUnaryTypeExpression.Contains(PeekToken(1)->Kind()))
+			return false;
+
+		i32 closeIndex = PeekMatchingToken();
+		return closeIndex == 0 || FirstOfUnaryExpression.Contains(PeekToken(closeIndex + 1)->Kind());
+	}
+
+	bool ParseMetaExpression(Expression*& out)
+	{
+		Token* dollarToken = EatToken();
+		Token* openToken = EatToken();
+
+		//the type context does not extend into the parentheses
+		Expression* expression;
+		if (!ParseExpression(false, Precedence::Expression, expression))
+			return false;
+
+		if (PeekToken()->Kind() != SyntaxKind::RParenSymbol)
+			return false;
+		Token* closeToken = EatToken();
+
+		out = CreateSyntax<MetaExpression>(dollarToken, openToken, expression, closeToken);
+		return true;
+	}
+
+	bool ParseInvokeExpression(bool typeExpr, InvokeOperator invokeOperator, SyntaxKind closeKind, Expression*& expression)
+	{
+		Token* openToken = EatToken();
+
+		ArgumentList* arguments;
+		if (!ParseArgumentList(typeExpr, arguments))
+			return false;
+
+		if (PeekToken()->Kind() != closeKind)
+			return false;
+		Token* closeToken = EatToken();
+
+		expression = CreateSyntax<InvokeExpression>(invokeOperator, expression, openToken, arguments, closeToken);
+		return true;
+	}
+
+	bool ParseAccessExpression(AccessOperator accessOperator, Expression*& expression)
+	{
+		Token* operatorToken = EatToken();
+
+		if (!IsWordToken(PeekToken()->Kind()))
+			return false;
+		WordToken* nameToken = static_cast<WordToken*>(EatToken());
+
+		expression = CreateSyntax<AccessExpression>(accessOperator, expression, operatorToken, nameToken);
+		return true;
+	}
+
+	bool ParseSpecializationExpression(Expression*& expression)
+	{
+		if (!ParseInvokeExpression(true, InvokeOperator::Specialization, SyntaxKind::RAngleSymbol, expression))
+			return false;
+
+		return !FollowRejectingSpecialization.Contains(PeekToken()->Kind());
+	}
+
+	bool ParsePrimaryExpression(bool typeExpr, Expression*& out)
+	{
+		Expression* expression = nullptr;
+
+		switch (PeekToken()->Kind())
+		{
+		case SyntaxKind::ScopeSymbol:
+			//rooted names are not supported by the grammar yet
+			return false;
+
+		COROGLL_CASE_SYNTAXKIND_KEYWORD
+		case SyntaxKind::NameToken:
+			expression = CreateSyntax<WordExpression>(static_cast<WordToken*>(EatToken()));
+			break;
+
+		case SyntaxKind::CharLiteralToken:
+		case SyntaxKind::StringLiteralToken:
+		case SyntaxKind::NumericLiteralToken:
+			expression = CreateSyntax<LiteralExpression>(static_cast<LiteralToken*>(EatToken()));
+			break;
+
+		case SyntaxKind::DollarSymbol:
+			if (PeekToken(1)->Kind() != SyntaxKind::LParenSymbol || !ParseMetaExpression(expression))
+				return false;
+			break;
+
+		case SyntaxKind::LParenSymbol:
+			if (typeExpr)
+				return false;
+
+			switch (ClassifyParenthesizedName())
+			{
+			case NameKind::Value:
+				if (!ParseParensExpression(expression))
+					return false;
+				break;
+
+			case NameKind::Type:
+			case NameKind::Template:
+				if (!ParseCastExpression(expression))
+					return false;
+				break;
+
+			default:
+				{
+					//the engine forks here, with the parenthesized expression preferred
+					i32 tokenIndex = m_tokenIndex;
+
+					if (ParseParensExpression(expression) && ParsePostfixExpression(typeExpr, expression, out))
+						return true;
+
+					m_tokenIndex = tokenIndex;
+
+					if (!PeekCastExpression())
+						return false;
+
+					return ParseCastExpression(expression) && ParsePostfixExpression(typeExpr, expression, out);
+				}
+			}
+			break;
+		}
+
+		return ParsePostfixExpression(typeExpr, expression, out);
+	}
+
+	bool ParsePostfixExpression(bool typeExpr, Expression* expression, Expression*& out)
+	{
+		while (true)
+		{
+			switch (PeekToken()->Kind())
+			{
+			case SyntaxKind::LParenSymbol:
+				if (typeExpr || !ParseInvokeExpression(typeExpr, InvokeOperator::Call, SyntaxKind::RParenSymbol, expression))
+					return false;
+				break;
+
+			case SyntaxKind::LBrackSymbol:
+				if (typeExpr || !ParseInvokeExpression(typeExpr, InvokeOperator::Index, SyntaxKind::RBrackSymbol, expression))
+					return false;
+				break;
+
+			case SyntaxKind::LAngleSymbol:
+				if (!typeExpr)
+				{
+					if (!IsTypeExpression(expression))
+						goto exit;
+
+					switch (ClassifyName(expression))
+					{
+					case NameKind::Template:
+						break;
+
+					case NameKind::Value:
+					case NameKind::Type:
+						goto exit;
+
+					default:
+						{
+							//the engine forks here, with the specialization preferred
+							if (PeekMatchingToken() != 0)
+							{
+								i32 tokenIndex = m_tokenIndex;
+								Expression* specialization = expression;
+
+								if (ParseSpecializationExpression(specialization) && ParsePostfixExpression(typeExpr, specialization, out))
+									return true;
+
+								m_tokenIndex = tokenIndex;
+							}
+							goto exit;
+						}
+					}
+				}
+
+				if (!ParseSpecializationExpression(expression))
+					return false;
+				break;
+
+			case SyntaxKind::ScopeSymbol:
+				if (!ParseAccessExpression(AccessOperator::Scope, expression))
+					return false;
+				break;
+
+			case SyntaxKind::DotSymbol:
+				if (typeExpr || !ParseAccessExpression(AccessOperator::Direct, expression))
+					return false;
+				break;
+
+			case SyntaxKind::ArrowSymbol:
+				if (typeExpr || !ParseAccessExpression(AccessOperator::Indirect, expression))
+					return false;
+				break;
+
+			case SyntaxKind::IncrementSymbol:
+				if (typeExpr)
+					return false;
+				expression = CreateSyntax<UnaryExpression>(UnaryOperator::PostfixIncrement, EatToken(), expression);
+				break;
+
+			case SyntaxKind::DecrementSymbol:
+				if (typeExpr)
+					return false;
+				expression = CreateSyntax<UnaryExpression>(UnaryOperator::PostfixDecrement, EatToken(), expression);
+				break;
+
+			default:
+				goto exit;
+			}
+		}
+	exit:
+
+		out = expression;
+		return true;
+	}
+
+	bool ParseUnaryExpression(bool typeExpr, Expression*& out)
+	{
+		UnaryOperator unaryOperator;
+
+		switch (PeekToken()->Kind())
+		{
+		case SyntaxKind::AddSymbol: unaryOperator = UnaryOperator::Plus; break;
+		case SyntaxKind::AndSymbol: unaryOperator = UnaryOperator::Addressof; break;
+		case SyntaxKind::AwaitKeyword: unaryOperator = UnaryOperator::Await; break;
+		case SyntaxKind::DecrementSymbol: unaryOperator = UnaryOperator::PrefixDecrement; break;
+		case SyntaxKind::MulSymbol: unaryOperator = UnaryOperator::Indirection; break;
+		case SyntaxKind::NotSymbol: unaryOperator = UnaryOperator::Not; break;
+		case SyntaxKind::IncrementSymbol: unaryOperator = UnaryOperator::PrefixIncrement; break;
+		case SyntaxKind::LogicalNotSymbol: unaryOperator = UnaryOperator::LogicalNot; break;
+		case SyntaxKind::SubSymbol: unaryOperator = UnaryOperator::Minus; break;
+
+		default:
+			return ParsePrimaryExpression(typeExpr, out);
+		}
+
+		Token* operatorToken = EatToken();
+
+		Expression* operand;
+		if (!ParseExpression(typeExpr, Precedence::UnaryPrefix, operand))
+			return false;
+
+		out = CreateSyntax<UnaryExpression>(unaryOperator, operatorToken, operand);
+		return true;
+	}
+
+	bool ParseExpression(bool typeExpr, Precedence precedence, Expression*& out)
+	{
+		struct Operation
+		{
+			Expression* leftOperand;
+			Token* operatorToken;
+			BinaryOperator binaryOperator;
+			Precedence precedence;
+		};
+
+		std::vector<Operation> operations;
+
+		Expression* leftOperand;
+		if (!ParseUnaryExpression(typeExpr, leftOperand))
+			return false;
+
+		if (typeExpr)
+		{
+			out = leftOperand;
+			return true;
+		}
+
+	parseOperator:
+		while (true)
+		{
+			i32 operatorTokenCount;
+			OperatorInfo operatorInfo = PeekBinaryOperator(&operatorTokenCount);
+
+			if (!operatorInfo.IsBinaryOperator())
+				break;
+
+			if (operatorInfo.precedence < precedence)
+				break;
+
+			if (operatorInfo.precedence == precedence && operatorInfo.associativity == Associativity::Left)
+				break;
+
+			Token* operatorToken = EatToken();
+			for (i32 i = 1; i < operatorTokenCount; ++i)
+				EatToken();
+
+			operations.push_back({ leftOperand, operatorToken, operatorInfo.binaryOperator, precedence });
+			precedence = operatorInfo.precedence;
+
+			if (!ParseUnaryExpression(typeExpr, leftOperand))
+				return false;
+		}
+
+		if (precedence <= Precedence::Ternary && PeekToken()->Kind() == SyntaxKind::QuestionSymbol)
+		{
+			Token* questionToken = EatToken();
+			Expression* trueExpression = nullptr;
+
+			if (PeekToken()->Kind() != SyntaxKind::ColonSymbol && !ParseExpression(typeExpr, Precedence::Expression, trueExpression))
+				return false;
+
+			if (PeekToken()->Kind() != SyntaxKind::ColonSymbol)
+				return false;
+			Token* colonToken = EatToken();
+
+			Expression* falseExpression;
+			if (!ParseExpression(typeExpr, Precedence::Expression, falseExpression))
+				return false;
+
+			leftOperand = CreateSyntax<TernaryExpression>(leftOperand, questionToken, trueExpression, colonToken, falseExpression);
+		}
+
+		if (!operations.empty())
+		{
+			Operation operation = operations.back();
+			operations.pop_back();
+
+			leftOperand = CreateSyntax<BinaryExpression>(operation.binaryOperator, operation.leftOperand, operation.operatorToken, leftOperand);
+			precedence = operation.precedence;
+
+			goto parseOperator;
+		}
+
+		out = leftOperand;
+		return true;
+	}
+
+	Span<Token*> m_tokens;
+	Span<const i32> m_brackets;
+	Private::SyntaxTreeContext* m_treeContext;
+	const ParseOptions* m_options;
+
+	i32 m_tokenIndex = 0;
+};
+
+bool TokenEquals(const Token* a, const Token* b)
+{
+	if (a == nullptr || b == nullptr)
+		return a == b;
+
+	return a->Kind() == b->Kind() && a->Pos().Line() == b->Pos().Line() && a->Pos().Column() == b->Pos().Column();
+}
+
+} // namespace
+
+SyntaxTree CoroGLL::Bench::ParseExpressionDescent(std::string_view text, const ParseOptions& options)
+{
+	Private::SyntaxTreeContext treeContext;
+	std::vector<Token*> tokenVector = Private::Lex(text, &treeContext);
+
+	Span<Token*> tokens(tokenVector.data(), tokenVector.size());
+	std::vector<i32> bracketVector = Private::MatchBrackets(tokens);
+
+	DescentParser parser(tokens, Span<const i32>(bracketVector.data(), bracketVector.size()), &treeContext, options);
+
+	Expression* root;
+	if (!parser.ParseRoot(root))
+		root = nullptr;
+
+	return Private::SyntaxTreeAttorney::CreateSyntaxTree(root, ParseStatus::Complete, std::move(treeContext));
+}
+
+bool CoroGLL::Bench::SyntaxEquals(const Syntax* a, const Syntax* b)
+{
+	if (a == nullptr || b == nullptr)
+		return a == b;
+
+	if (a->Kind() != b->Kind())
+		return false;
+
+	switch (a->Kind())
+	{
+	case SyntaxKind::CastExpression:
+		{
+			auto x = static_cast<const CastExpression*>(a);
+			auto y = static_cast<const CastExpression*>(b);
+			return SyntaxEquals(x->type, y->type) && SyntaxEquals(x->expression, y->expression)
+				&& TokenEquals(x->openToken, y->openToken) && TokenEquals(x->closeToken, y->closeToken);
+		}
+
+	case SyntaxKind::LiteralExpression:
+		return TokenEquals(static_cast<const LiteralExpression*>(a)->literalToken, static_cast<const LiteralExpression*>(b)->literalToken);
+
+	case SyntaxKind::MetaExpression:
+		{
+			auto x = static_cast<const MetaExpression*>(a);
+			auto y = static_cast<const MetaExpression*>(b);
+			return SyntaxEquals(x->expression, y->expression) && TokenEquals(x->dollarToken, y->dollarToken)
+				&& TokenEquals(x->openToken, y->openToken) && TokenEquals(x->closeToken, y->closeToken);
+		}
+
+	case SyntaxKind::ParenthesizedExpression:
+		{
+			auto x = static_cast<const ParenthesizedExpression*>(a);
+			auto y = static_cast<const ParenthesizedExpression*>(b);
+			return SyntaxEquals(x->expression, y->expression)
+				&& TokenEquals(x->openToken, y->openToken) && TokenEquals(x->closeToken, y->closeToken);
+		}
+
+	case SyntaxKind::TernaryExpression:
+		{
+			auto x = static_cast<const TernaryExpression*>(a);
+			auto y = static_cast<const TernaryExpression*>(b);
+			return SyntaxEquals(x->condition, y->condition) && SyntaxEquals(x->trueExpression, y->trueExpression)
+				&& SyntaxEquals(x->falseExpression, y->falseExpression)
+				&& TokenEquals(x->questionToken, y->questionToken) && TokenEquals(x->colonToken, y->colonToken);
+		}
+
+	case SyntaxKind::WordExpression:
+		return TokenEquals(static_cast<const WordExpression*>(a)->nameToken, static_cast<const WordExpression*>(b)->nameToken);
+
+	case SyntaxKind::Argument:
+		{
+			auto x = static_cast<const Argument*>(a);
+			auto y = static_cast<const Argument*>(b);
+			return SyntaxEquals(x->expression, y->expression)
+				&& TokenEquals(x->nameToken, y->nameToken) && TokenEquals(x->colonToken, y->colonToken);
+		}
+
+	case SyntaxKind::ArgumentList:
+		{
+			Span<Argument*> x = static_cast<const ArgumentList*>(a)->arguments;
+			Span<Argument*> y = static_cast<const ArgumentList*>(b)->arguments;
+
+			if (x.Size() != y.Size())
+				return false;
+
+			for (i32 index = 0; index < x.Size(); ++index)
+			{
+				if (!SyntaxEquals(x[index], y[index]))
+					return false;
+			}
+			return true;
+		}
+
+#define COROGLL_X(n) case SyntaxKind::n ## Expression:
+	COROGLL_UNARY_OPERATOR(COROGLL_X)
+#undef COROGLL_X
+		{
+			auto x = static_cast<const UnaryExpression*>(a);
+			auto y = static_cast<const UnaryExpression*>(b);
+			return SyntaxEquals(x->expression, y->expression) && TokenEquals(x->operatorToken, y->operatorToken);
+		}
+
+#define COROGLL_X(n) case SyntaxKind::n ## Expression:
+	COROGLL_BINARY_OPERATOR(COROGLL_X)
+#undef COROGLL_X
+		{
+			auto x = static_cast<const BinaryExpression*>(a);
+			auto y = static_cast<const BinaryExpression*>(b);
+			return SyntaxEquals(x->leftExpression, y->leftExpression) && SyntaxEquals(x->rightExpression, y->rightExpression)
+				&& TokenEquals(x->operatorToken, y->operatorToken);
+		}
+
+#define COROGLL_X(n) case SyntaxKind::n ## Expression:
+	COROGLL_INVOKE_OPERATOR(COROGLL_X)
+#undef COROGLL_X
+		{
+			auto x = static_cast<const InvokeExpression*>(a);
+			auto y = static_cast<const InvokeExpression*>(b);
+			return SyntaxEquals(x->expression, y->expression) && SyntaxEquals(x->arguments, y->arguments)
+				&& TokenEquals(x->openToken, y->openToken) && TokenEquals(x->closeToken, y->closeToken);
+		}
+
+#define COROGLL_X(n) case SyntaxKind::n ## AccessExpression:
+	COROGLL_ACCESS_OPERATOR(COROGLL_X)
+#undef COROGLL_X
+		{
+			auto x = static_cast<const AccessExpression*>(a);
+			auto y = static_cast<const AccessExpression*>(b);
+			return SyntaxEquals(x->expression, y->expression)
+				&& TokenEquals(x->nameToken, y->nameToken) && TokenEquals(x->operatorToken, y->operatorToken);
+		}
+	}
+
+	//kinds the expression grammar does not produce
+	Assert(false);
+	return false;
+}
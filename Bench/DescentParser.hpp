@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ParseOptions.hpp"
+#include "SyntaxTree.hpp"
+
+#include <string_view>
+
+namespace CoroGLL::Bench {
+
+// Parses an expression by deterministic recursive descent over the same grammar
+// as the engine. The alternatives of each ambiguity are tried in the engine's
+// order of preference, backtracking to the next one when the rest of the rule
+// fails, so the trees are the same. Nothing is memoized.
+// Only the name oracle and the operator table of the options are used.
+SyntaxTree ParseExpressionDescent(std::string_view text, const ParseOptions& options);
+
+// Compares two trees by structure, and their tokens by kind and position.
+bool SyntaxEquals(const Ast::Syntax* a, const Ast::Syntax* b);
+
+} // namespace CoroGLL::Bench
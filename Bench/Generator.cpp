@@ -0,0 +1,175 @@
+#include "Generator.hpp"
+
+#include <algorithm>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Bench;
+
+namespace {
+
+//relational operators are left out, as they are generated as ambiguities
+const char* const BinaryOperators[] = {
+	" + ", " - ", " * ", " / ", " % ",
+	" == ", " != ", " && ", " || ",
+	" & ", " | ", " ^ ", " << ",
+};
+
+const char* const Names[] = {
+	"a", "b", "c", "x", "y", "z", "f", "g", "T", "value", "count", "index",
+};
+
+} // namespace
+
+CoroGLL::Bench::ExpressionGenerator::ExpressionGenerator(const GeneratorOptions& options, u32 seed)
+	: m_options(options), m_random(seed)
+{
+}
+
+std::string CoroGLL::Bench::ExpressionGenerator::Generate()
+{
+	std::string out;
+	GenerateExpression(out, std::max(m_options.size, 1), m_options.depth);
+	return out;
+}
+
+void CoroGLL::Bench::ExpressionGenerator::GenerateExpression(std::string& out, i32 size, i32 depth)
+{
+	GenerateOperand(out, depth);
+
+	for (i32 index = 1; index < size; ++index)
+	{
+		out += BinaryOperators[Pick(std::size(BinaryOperators))];
+		GenerateOperand(out, depth);
+	}
+}
+
+void CoroGLL::Bench::ExpressionGenerator::GenerateOperand(std::string& out, i32 depth)
+{
+	if (Chance(m_options.ambiguity))
+		return GenerateAmbiguousOperand(out, depth);
+
+	if (Chance(0.1))
+		out += Pick(2) == 0 ? "-" : "!";
+
+	//nested expressions are smaller, so that the total size stays bounded
+	i32 size = std::max(m_options.size / 2, 1);
+
+	if (depth > 0 && Chance(0.3))
+	{
+		switch (Pick(3))
+		{
+		case 0:
+			out += '(';
+			GenerateExpression(out, size, depth - 1);
+			out += ')';
+			break;
+
+		case 1:
+			GenerateName(out);
+			out += '(';
+			GenerateExpression(out, size, depth - 1);
+			out += ", ";
+			GenerateExpression(out, size, depth - 1);
+			out += ')';
+			break;
+
+		case 2:
+			GenerateName(out);
+			out += '[';
+			GenerateExpression(out, size, depth - 1);
+			out += ']';
+			break;
+		}
+		return;
+	}
+
+	switch (Pick(4))
+	{
+	case 0:
+		out += std::to_string(Pick(1000));
+		break;
+
+	case 1:
+		GenerateName(out);
+		out += '.';
+		GenerateName(out);
+		break;
+
+	default:
+		GenerateName(out);
+		break;
+	}
+}
+
+void CoroGLL::Bench::ExpressionGenerator::GenerateAmbiguousOperand(std::string& out, i32 depth)
+{
+	switch (Pick(5))
+	{
+	case 0:
+		//specialization call or two comparisons
+		GenerateName(out);
+		out += '<';
+		GenerateName(out);
+		out += ">(";
+		if (depth > 0)
+			GenerateExpression(out, std::max(m_options.size / 2, 1), depth - 1);
+		else GenerateName(out);
+		out += ')';
+		break;
+
+	case 1:
+		//comparison chain which could open a specialization
+		GenerateName(out);
+		out += " < ";
+		GenerateName(out);
+		out += " > ";
+		GenerateName(out);
+		break;
+
+	case 2:
+		//nested specialization
+		GenerateName(out);
+		out += '<';
+		GenerateName(out);
+		out += '<';
+		GenerateName(out);
+		out += ">>(";
+		GenerateName(out);
+		out += ')';
+		break;
+
+	case 3:
+		//cast of a parenthesized expression or a call of a parenthesized name
+		out += '(';
+		GenerateName(out);
+		out += ")(";
+		if (depth > 0)
+			GenerateExpression(out, std::max(m_options.size / 2, 1), depth - 1);
+		else GenerateName(out);
+		out += ')';
+		break;
+
+	case 4:
+		//cast of a negation or a subtraction
+		out += '(';
+		GenerateName(out);
+		out += ") - ";
+		GenerateName(out);
+		break;
+	}
+}
+
+void CoroGLL::Bench::ExpressionGenerator::GenerateName(std::string& out)
+{
+	out += Names[Pick(std::size(Names))];
+}
+
+bool CoroGLL::Bench::ExpressionGenerator::Chance(double probability)
+{
+	return std::uniform_real_distribution<double>(0, 1)(m_random) < probability;
+}
+
+i32 CoroGLL::Bench::ExpressionGenerator::Pick(i32 count)
+{
+	return std::uniform_int_distribution<i32>(0, count - 1)(m_random);
+}
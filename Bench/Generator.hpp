@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <random>
+#include <string>
+
+namespace CoroGLL::Bench {
+
+struct GeneratorOptions
+{
+	// number of operands of each expression, not counting nested ones.
+	i32 size = 8;
+
+	// maximum nesting of parenthesized subexpressions, arguments and indices.
+	i32 depth = 2;
+
+	// probability of an operand being a construct the parser has to fork on:
+	// angle brackets which may be a specialization or comparisons, and
+	// parenthesized names which may be a cast.
+	double ambiguity = 0.2;
+};
+
+// Generates random valid expressions of a controlled shape.
+class ExpressionGenerator
+{
+public:
+	ExpressionGenerator(const GeneratorOptions& options, u32 seed);
+
+	std::string Generate();
+
+private:
+	void GenerateExpression(std::string& out, i32 size, i32 depth);
+	void GenerateOperand(std::string& out, i32 depth);
+	void GenerateAmbiguousOperand(std::string& out, i32 depth);
+	void GenerateName(std::string& out);
+
+	bool Chance(double probability);
+	i32 Pick(i32 count);
+
+	GeneratorOptions m_options;
+	std::mt19937 m_random;
+};
+
+} // namespace CoroGLL::Bench
@@ -0,0 +1,227 @@
+#include "Lexing.hpp"
+
+#include "Lexer.hpp"
+#include "Syntax/Keyword.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Bench;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const std::string_view Keywords[] = {
+#define COROGLL_X(n, s) s,
+	COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+};
+
+const std::string_view Symbols[] = {
+	"+", "-", "*", "/", "%", "<<", "<", "<=", "==", "!=", "&&", "||",
+	"+=", "->", "::", "?", "??", ".", ",", "(", ")", "[", "]",
+};
+
+class InputGenerator
+{
+public:
+	explicit InputGenerator(u32 seed)
+		: m_random(seed)
+	{
+	}
+
+	void Identifier(std::string& text)
+	{
+		static constexpr std::string_view First = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+		static constexpr std::string_view Rest = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+
+		//prefixed so as to never spell a keyword
+		text += 'x';
+		text += First[Next(First.size())];
+		for (i32 length = Range(0, 12); length > 0; --length)
+			text += Rest[Next(Rest.size())];
+		text += ' ';
+	}
+
+	void Keyword(std::string& text)
+	{
+		text += Keywords[Next(std::size(Keywords))];
+		text += ' ';
+	}
+
+	void Number(std::string& text)
+	{
+		switch (Next(3))
+		{
+		case 0:
+			text += std::to_string(Next(1000000));
+			break;
+
+		case 1:
+			//kept small, as the literal value must not overflow the lexer's rationals
+			text += std::to_string(Next(1000));
+			text += '.';
+			text += std::to_string(Next(1000));
+			text += Next(2) != 0 ? "e+" : "e-";
+			text += std::to_string(Range(1, 9));
+			break;
+
+		case 2:
+			text += "0x";
+			for (i32 length = Range(1, 8); length > 0; --length)
+				text += "0123456789abcdef"[Next(16)];
+			break;
+		}
+		text += ' ';
+	}
+
+	void String(std::string& text)
+	{
+		static constexpr std::string_view Escapes[] = { "\\n", "\\t", "\\\\", "\\\"", "\\'", "\\0" };
+
+		text += '"';
+		for (i32 length = Range(4, 32); length > 0; --length)
+		{
+			if (Next(4) == 0)
+				text += Escapes[Next(std::size(Escapes))];
+			else text += (char)('a' + Next(26));
+		}
+		text += "\" ";
+	}
+
+	void Char(std::string& text)
+	{
+		text += '\'';
+		if (Next(2) == 0)
+			text += "\\n";
+		else text += (char)('a' + Next(26));
+		text += "' ";
+	}
+
+	void Symbol(std::string& text)
+	{
+		text += Symbols[Next(std::size(Symbols))];
+		text += ' ';
+	}
+
+	void Comment(std::string& text)
+	{
+		bool line = Next(2) == 0;
+		text += line ? "//" : "/*";
+		for (i32 length = Range(8, 64); length > 0; --length)
+			text += (char)(Next(8) == 0 ? ' ' : 'a' + Next(26));
+		text += line ? "\n" : "*/ ";
+
+		//comments are trivia of the following token
+		if (Next(4) == 0)
+			text += "x ";
+	}
+
+	void Whitespace(std::string& text)
+	{
+		static constexpr std::string_view Spaces = " \t\n";
+
+		text += 'x';
+		for (i32 length = Range(8, 64); length > 0; --length)
+			text += Spaces[Next(Spaces.size())];
+	}
+
+private:
+	u32 Next(u32 count)
+	{
+		return std::uniform_int_distribution<u32>(0, count - 1)(m_random);
+	}
+
+	i32 Range(i32 min, i32 max)
+	{
+		return std::uniform_int_distribution<i32>(min, max)(m_random);
+	}
+
+	std::mt19937 m_random;
+};
+
+struct InputClass
+{
+	const char* name;
+	void(InputGenerator::*generate)(std::string& text);
+};
+
+const InputClass InputClasses[] = {
+	{ "identifiers", &InputGenerator::Identifier },
+	{ "keywords",    &InputGenerator::Keyword    },
+	{ "numbers",     &InputGenerator::Number     },
+	{ "strings",     &InputGenerator::String     },
+	{ "chars",       &InputGenerator::Char       },
+	{ "symbols",     &InputGenerator::Symbol     },
+	{ "comments",    &InputGenerator::Comment    },
+	{ "whitespace",  &InputGenerator::Whitespace },
+};
+
+} // namespace
+
+void CoroGLL::Bench::RunLexing(const LexingOptions& options)
+{
+	std::cout
+		<< std::setw(12) << "class"
+		<< std::setw(10) << "bytes"
+		<< std::setw(10) << "tokens"
+		<< std::setw(12) << "ns/byte"
+		<< std::setw(12) << "ns/tok"
+		<< std::setw(12) << "arena/tok"
+		<< std::setw(12) << "heap/tok" << '\n';
+
+	for (const InputClass& inputClass : InputClasses)
+	{
+		InputGenerator generator(options.seed);
+
+		std::string text;
+		while (text.size() < (size_t)options.size)
+			(generator.*inputClass.generate)(text);
+
+		u64 best = std::numeric_limits<u64>::max();
+		u64 tokens = 0;
+		u64 arenaAllocations = 0;
+		u64 heapAllocations = 0;
+
+		for (i32 repeat = 0; repeat < options.repeats; ++repeat)
+		{
+			Private::SyntaxTreeContext treeContext;
+			u64 heapAllocationStart = GetHeapAllocationCount();
+
+			auto start = Clock::now();
+			std::vector<Ast::Token*> tokenVector = Private::Lex(text, &treeContext);
+			best = std::min(best, (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+			tokens = tokenVector.size();
+			arenaAllocations = treeContext.AllocationCount();
+			heapAllocations = GetHeapAllocationCount() - heapAllocationStart;
+
+			//the result grows one token at a time, its reallocations are not the lexer's own
+			u64 growthAllocationStart = GetHeapAllocationCount();
+			{
+				std::vector<Ast::Token*> growth;
+				for (u64 index = 0; index < tokens; ++index)
+					growth.push_back(nullptr);
+			}
+			heapAllocations -= GetHeapAllocationCount() - growthAllocationStart;
+		}
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< std::setw(12) << inputClass.name
+			<< std::setw(10) << text.size()
+			<< std::setw(10) << tokens
+			<< std::setw(12) << (double)best / text.size()
+			<< std::setw(12) << (double)best / tokens
+			<< std::setw(12) << (double)arenaAllocations / tokens
+			<< std::setw(12) << (double)heapAllocations / tokens << '\n';
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace CoroGLL::Bench {
+
+struct LexingOptions
+{
+	// approximate size of each generated input, in bytes.
+	i32 size = 1 << 16;
+
+	// each input is lexed this many times, keeping the fastest.
+	i32 repeats = 5;
+
+	u32 seed = 1;
+};
+
+// Number of heap allocations made so far by the benchmark executable.
+u64 GetHeapAllocationCount();
+
+// Lexes generated inputs dominated by each class of token or trivia, reporting
+// the time per byte and per token, and the allocations per token. The heap
+// allocations exclude the growth of the resulting token vector.
+void RunLexing(const LexingOptions& options);
+
+} // namespace CoroGLL::Bench
@@ -0,0 +1,546 @@
+#include "Baseline.hpp"
+#include "DescentParser.hpp"
+#include "Generator.hpp"
+#include "Lexing.hpp"
+#include "Scaling.hpp"
+
+#include "Lexer.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Bench;
+
+namespace {
+
+u64 heapAllocationCount = 0;
+
+} // namespace
+
+// The replacements count the heap allocations of the whole executable, not
+// only those of the lexer, so --lexing takes the difference around each lex.
+void* operator new(std::size_t size)
+{
+	++heapAllocationCount;
+
+	if (void* pointer = std::malloc(size != 0 ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+u64 CoroGLL::Bench::GetHeapAllocationCount()
+{
+	return heapAllocationCount;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Configuration
+{
+	const char* name;
+	EngineMode engineMode;
+	SchedulingPolicy schedulingPolicy;
+};
+
+const Configuration Configurations[] = {
+	{ "least-advanced", EngineMode::Generalized,   SchedulingPolicy::LeastAdvanced },
+	{ "depth-first",    EngineMode::Generalized,   SchedulingPolicy::DepthFirst    },
+	{ "round-robin",    EngineMode::Generalized,   SchedulingPolicy::RoundRobin    },
+	{ "ordered-choice", EngineMode::OrderedChoice, SchedulingPolicy::LeastAdvanced },
+};
+
+const double SuiteAmbiguities[] = { 0, 0.1, 0.25, 0.5, 1 };
+
+struct Arguments
+{
+	enum class Mode
+	{
+		Compare,
+		Generate,
+		Suite,
+		Scaling,
+		Lexing,
+		CheckBaseline,
+		RecordBaseline,
+	};
+
+	Mode mode = Mode::Compare;
+	const char* corpusPath = nullptr;
+	const char* baselinePath = nullptr;
+
+	GeneratorOptions generator;
+	ScalingOptions scaling;
+	LexingOptions lexing;
+	i32 count = 100;
+	u32 seed = 1;
+};
+
+u64 Nanoseconds(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+std::vector<std::string> ReadCorpus(std::istream& is)
+{
+	std::vector<std::string> corpus;
+	for (std::string line; std::getline(is, line);)
+	{
+		if (!line.empty() && line[0] != '#')
+			corpus.push_back(std::move(line));
+	}
+	return corpus;
+}
+
+std::vector<std::string> GenerateCorpus(const GeneratorOptions& options, i32 count, u32 seed)
+{
+	ExpressionGenerator generator(options, seed);
+
+	std::vector<std::string> corpus;
+	for (i32 index = 0; index < count; ++index)
+		corpus.push_back(generator.Generate());
+	return corpus;
+}
+
+void Run(const Configuration& configuration, const std::vector<std::string>& corpus)
+{
+	ParseOptions options;
+	options.engineMode = configuration.engineMode;
+	options.schedulingPolicy = configuration.schedulingPolicy;
+
+	ParseStats total;
+	i32 failures = 0;
+
+	auto start = Clock::now();
+	for (const std::string& source : corpus)
+	{
+		ParseStats stats;
+		options.stats = &stats;
+
+		SyntaxTree tree = ParseExpression(source, options);
+		if (tree.GetRoot() == nullptr)
+			++failures;
+
+		Accumulate(total, stats);
+	}
+	auto end = Clock::now();
+
+	//every configuration must build the same trees as the first one
+	const Configuration& reference = Configurations[0];
+
+	ParseOptions referenceOptions;
+	referenceOptions.engineMode = reference.engineMode;
+	referenceOptions.schedulingPolicy = reference.schedulingPolicy;
+
+	options.stats = nullptr;
+	i32 mismatches = 0;
+
+	if (&configuration != &reference)
+	{
+		for (const std::string& source : corpus)
+		{
+			if (!SyntaxEquals(ParseExpression(source, options).GetRoot(), ParseExpression(source, referenceOptions).GetRoot()))
+			{
+				std::cerr << configuration.name << " mismatch: " << source << '\n';
+				++mismatches;
+			}
+		}
+	}
+
+	std::cout << configuration.name
+		<< "\ttokens " << total.tokens
+		<< "\tsteps " << total.steps
+		<< "\tframes " << total.frames
+		<< "\tmemo hits " << total.memoHits
+		<< "\tforks " << total.forks
+		<< "\tterminated " << total.forksTerminated
+		<< "\tcopied " << total.forkBytesCopied
+		<< "\tpeak forks " << total.peakLiveForks
+		<< "\tpeak bytes " << total.peakCoroutineBytes
+		<< "\ttree bytes " << total.treeBytes
+		<< "\tfailures " << failures
+		<< "\tmismatches " << mismatches
+		<< "\tlex " << total.lexNanoseconds / 1000 << "us"
+		<< "\tmatch " << total.matchNanoseconds / 1000 << "us"
+		<< "\tparse " << total.parseNanoseconds / 1000 << "us"
+		<< "\ttime " << Nanoseconds(start, end) / 1000 << "us\n";
+}
+
+// Sums the deterministic counters of each configuration over a corpus.
+std::vector<ParseStats> CountWork(const std::vector<std::string>& corpus)
+{
+	std::vector<ParseStats> totals;
+	for (const Configuration& configuration : Configurations)
+	{
+		ParseOptions options;
+		options.engineMode = configuration.engineMode;
+		options.schedulingPolicy = configuration.schedulingPolicy;
+
+		ParseStats& total = totals.emplace_back();
+		for (const std::string& source : corpus)
+		{
+			ParseStats stats;
+			options.stats = &stats;
+
+			ParseExpression(source, options);
+			Accumulate(total, stats);
+		}
+	}
+	return totals;
+}
+
+bool RecordBaseline(const char* path, const char* corpusPath, const std::vector<std::string>& corpus)
+{
+	std::vector<ParseStats> totals = CountWork(corpus);
+
+	Baseline baseline;
+	if constexpr (RecordBaselineBytes)
+		baseline.SetToolchain(GetBuildToolchain());
+
+	for (size_t index = 0; index < totals.size(); ++index)
+		baseline.Set(Configurations[index].name, totals[index]);
+
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cerr << "cannot open " << path << '\n';
+		return false;
+	}
+
+	file << "# work done parsing " << (corpusPath != nullptr ? corpusPath : "standard input") << ", recorded by Bench --record-baseline.\n";
+	if constexpr (!RecordBaselineBytes)
+		file << "# byte counters depend on the compiler's layouts and are only recorded by MSVC builds.\n";
+	baseline.Write(file);
+	return true;
+}
+
+bool CheckBaseline(const char* path, const std::vector<std::string>& corpus)
+{
+	std::ifstream file(path);
+
+	Baseline baseline;
+	if (!file || !baseline.Read(file))
+	{
+		std::cerr << "cannot read " << path << '\n';
+		return false;
+	}
+
+	if (baseline.GetToolchain().empty())
+		std::cout << "no byte counters recorded, record the baseline with MSVC to check them\n";
+	else if (baseline.GetToolchain() != GetBuildToolchain())
+		std::cout << "recorded by " << baseline.GetToolchain() << ", checking byte counters as ratios\n";
+
+	std::vector<ParseStats> totals = CountWork(corpus);
+
+	bool success = true;
+	for (size_t index = 0; index < totals.size(); ++index)
+	{
+		if (!baseline.Check(Configurations[index].name, totals[index], std::cout))
+			success = false;
+	}
+
+	std::cout << (success ? "within baseline\n" : "baseline exceeded\n");
+	return success;
+}
+
+// Times the recursive descent baseline, then checks its trees against the engine.
+void RunDescent(const std::vector<std::string>& corpus)
+{
+	ParseOptions options;
+	i32 failures = 0;
+	i32 mismatches = 0;
+
+	auto start = Clock::now();
+	for (const std::string& source : corpus)
+	{
+		SyntaxTree tree = ParseExpressionDescent(source, options);
+		if (tree.GetRoot() == nullptr)
+			++failures;
+	}
+	auto end = Clock::now();
+
+	for (const std::string& source : corpus)
+	{
+		if (!SyntaxEquals(ParseExpressionDescent(source, options).GetRoot(), ParseExpression(source, options).GetRoot()))
+		{
+			std::cerr << "mismatch: " << source << '\n';
+			++mismatches;
+		}
+	}
+
+	std::cout << "descent"
+		<< "\tfailures " << failures
+		<< "\tmismatches " << mismatches
+		<< "\ttime " << Nanoseconds(start, end) / 1000 << "us\n";
+}
+
+// Measures lexing alone, parsing alone and both together on a corpus, and
+// compares the total against the recursive descent baseline.
+void Measure(double ambiguity, const std::vector<std::string>& corpus)
+{
+	u64 bytes = 0;
+	u64 tokens = 0;
+	u64 lexNanoseconds = 0;
+	u64 parseNanoseconds = 0;
+	u64 totalNanoseconds = 0;
+	u64 descentNanoseconds = 0;
+	u64 peakCoroutineBytes = 0;
+	u64 peakTreeBytes = 0;
+	i32 mismatches = 0;
+	i32 failures = 0;
+
+	ParseOptions options;
+
+	for (const std::string& source : corpus)
+	{
+		auto lexStart = Clock::now();
+		TokenList tokenList = Lex(source);
+		u64 sourceLexNanoseconds = Nanoseconds(lexStart, Clock::now());
+
+		ParseStats stats;
+		options.stats = &stats;
+
+		auto start = Clock::now();
+		SyntaxTree tree = ParseExpression(source, options);
+		u64 sourceNanoseconds = Nanoseconds(start, Clock::now());
+
+		//a failed parse stops early, timing it would flatter the engine
+		if (tree.GetStatus() != ParseStatus::Complete || tree.GetRoot() == nullptr)
+		{
+			++failures;
+			continue;
+		}
+
+		bytes += source.size();
+		tokens += tokenList.Count();
+		lexNanoseconds += sourceLexNanoseconds;
+		totalNanoseconds += sourceNanoseconds;
+
+		auto descentStart = Clock::now();
+		SyntaxTree descentTree = ParseExpressionDescent(source, options);
+		descentNanoseconds += Nanoseconds(descentStart, Clock::now());
+
+		if (!SyntaxEquals(descentTree.GetRoot(), tree.GetRoot()))
+			++mismatches;
+
+		parseNanoseconds += stats.parseNanoseconds;
+		peakCoroutineBytes = std::max(peakCoroutineBytes, stats.peakCoroutineBytes);
+		peakTreeBytes = std::max(peakTreeBytes, stats.treeBytes);
+	}
+
+	auto perToken = [&](u64 nanoseconds) { return tokens != 0 ? (double)nanoseconds / tokens : 0; };
+	auto throughput = [&](u64 nanoseconds) { return nanoseconds != 0 ? bytes * 1e3 / nanoseconds : 0; };
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< std::setw(10) << ambiguity
+		<< std::setw(10) << tokens
+		<< std::setw(14) << perToken(lexNanoseconds)
+		<< std::setw(14) << perToken(parseNanoseconds)
+		<< std::setw(14) << perToken(totalNanoseconds)
+		<< std::setw(14) << throughput(lexNanoseconds)
+		<< std::setw(14) << throughput(totalNanoseconds)
+		<< std::setw(14) << peakCoroutineBytes
+		<< std::setw(14) << peakTreeBytes
+		<< std::setw(14) << perToken(descentNanoseconds)
+		<< std::setw(14) << (descentNanoseconds != 0 ? (double)totalNanoseconds / descentNanoseconds : 0)
+		<< std::setw(14) << mismatches
+		<< std::setw(14) << failures << '\n';
+}
+
+void RunSuite(const Arguments& arguments)
+{
+	std::cout
+		<< std::setw(10) << "ambiguity"
+		<< std::setw(10) << "tokens"
+		<< std::setw(14) << "lex ns/tok"
+		<< std::setw(14) << "parse ns/tok"
+		<< std::setw(14) << "total ns/tok"
+		<< std::setw(14) << "lex MB/s"
+		<< std::setw(14) << "total MB/s"
+		<< std::setw(14) << "peak coro"
+		<< std::setw(14) << "peak tree"
+		<< std::setw(14) << "descent/tok"
+		<< std::setw(14) << "overhead"
+		<< std::setw(14) << "mismatches"
+		<< std::setw(14) << "failures" << '\n';
+
+	for (double ambiguity : SuiteAmbiguities)
+	{
+		GeneratorOptions generator = arguments.generator;
+		generator.ambiguity = ambiguity;
+
+		Measure(ambiguity, GenerateCorpus(generator, arguments.count, arguments.seed));
+	}
+}
+
+bool ParseArguments(int argc, char** argv, Arguments& arguments)
+{
+	for (int index = 1; index < argc; ++index)
+	{
+		std::string_view arg = argv[index];
+		const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+		if (arg == "--generate")
+			arguments.mode = Arguments::Mode::Generate;
+		else if (arg == "--suite")
+			arguments.mode = Arguments::Mode::Suite;
+		else if (arg == "--scaling")
+			arguments.mode = Arguments::Mode::Scaling;
+		else if (arg == "--lexing")
+			arguments.mode = Arguments::Mode::Lexing;
+		else if (arg == "--lexing-size" && value != nullptr)
+			arguments.lexing.size = std::atoi(argv[++index]);
+		else if (arg == "--check-baseline" && value != nullptr)
+		{
+			arguments.mode = Arguments::Mode::CheckBaseline;
+			arguments.baselinePath = argv[++index];
+		}
+		else if (arg == "--record-baseline" && value != nullptr)
+		{
+			arguments.mode = Arguments::Mode::RecordBaseline;
+			arguments.baselinePath = argv[++index];
+		}
+		else if (arg == "--max-size" && value != nullptr)
+			arguments.scaling.maxSize = std::atoi(argv[++index]);
+		else if (arg == "--tolerance" && value != nullptr)
+			arguments.scaling.tolerance = std::atof(argv[++index]);
+		else if (arg == "--size" && value != nullptr)
+			arguments.generator.size = std::atoi(argv[++index]);
+		else if (arg == "--depth" && value != nullptr)
+			arguments.generator.depth = std::atoi(argv[++index]);
+		else if (arg == "--ambiguity" && value != nullptr)
+			arguments.generator.ambiguity = std::atof(argv[++index]);
+		else if (arg == "--count" && value != nullptr)
+			arguments.count = std::atoi(argv[++index]);
+		else if (arg == "--seed" && value != nullptr)
+			arguments.seed = std::atoi(argv[++index]);
+		else if (!arg.starts_with("--") && arguments.corpusPath == nullptr)
+			arguments.corpusPath = argv[index];
+		else
+		{
+			std::cerr << "unknown argument " << arg << '\n';
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+// Benchmarks the parser.
+//   [file]           compares the engine configurations on a corpus of
+//                    expressions, one per line, read from the file or standard input,
+//                    and against the recursive descent baseline. Lines starting
+//                    with # are comments. Trees differing from those of the
+//                    first configuration are reported as mismatches.
+//   --generate       prints a generated corpus instead.
+//   --suite          measures lexing and parsing on generated corpora of
+//                    increasing ambiguity, against the recursive descent baseline.
+//   --scaling        fits the growth exponents of corpus families up to
+//                    --max-size, failing if the steps, memory or time of any
+//                    exceeds its bound by --tolerance.
+//   --lexing         measures the lexer on inputs of --lexing-size bytes, each
+//                    dominated by one class of token or trivia.
+//   --check-baseline <file>
+//                    parses the corpus with each configuration and fails if any
+//                    deterministic counter exceeds its value in the baseline file
+//                    by more than the headroom.
+//   --record-baseline <file>
+//                    writes the counters of the corpus as the new baseline instead.
+// Generated corpora are shaped by --size, --depth, --ambiguity, --count and --seed.
+int main(int argc, char** argv)
+{
+	Arguments arguments;
+	if (!ParseArguments(argc, argv, arguments))
+		return 1;
+
+	std::vector<std::string> corpus;
+	switch (arguments.mode)
+	{
+	case Arguments::Mode::Compare:
+	case Arguments::Mode::CheckBaseline:
+	case Arguments::Mode::RecordBaseline:
+		if (arguments.corpusPath != nullptr)
+		{
+			std::ifstream file(arguments.corpusPath);
+			if (!file)
+			{
+				std::cerr << "cannot open " << arguments.corpusPath << '\n';
+				return 1;
+			}
+			corpus = ReadCorpus(file);
+		}
+		else corpus = ReadCorpus(std::cin);
+		break;
+	}
+
+	switch (arguments.mode)
+	{
+	case Arguments::Mode::Compare:
+		for (const Configuration& configuration : Configurations)
+			Run(configuration, corpus);
+
+		RunDescent(corpus);
+		break;
+
+	case Arguments::Mode::Lexing:
+		arguments.lexing.seed = arguments.seed;
+		RunLexing(arguments.lexing);
+		break;
+
+	case Arguments::Mode::CheckBaseline:
+		if (!EnableParseStats)
+		{
+			std::cerr << "parse stats are compiled out\n";
+			return 1;
+		}
+		if (!CheckBaseline(arguments.baselinePath, corpus))
+			return 2;
+		break;
+
+	case Arguments::Mode::RecordBaseline:
+		if (!EnableParseStats)
+		{
+			std::cerr << "parse stats are compiled out\n";
+			return 1;
+		}
+		if (!RecordBaseline(arguments.baselinePath, arguments.corpusPath, corpus))
+			return 1;
+		break;
+
+	case Arguments::Mode::Generate:
+		for (const std::string& source : GenerateCorpus(arguments.generator, arguments.count, arguments.seed))
+			std::cout << source << '\n';
+		break;
+
+	case Arguments::Mode::Suite:
+		RunSuite(arguments);
+		break;
+
+	case Arguments::Mode::Scaling:
+		if (!RunScaling(arguments.scaling))
+			return 2;
+		break;
+	}
+}
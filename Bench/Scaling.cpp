@@ -0,0 +1,195 @@
+#include "Scaling.hpp"
+#include "Generator.hpp"
+
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Bench;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+std::string Repeat(std::string_view string, i32 count)
+{
+	std::string out;
+	for (i32 index = 0; index < count; ++index)
+		out += string;
+	return out;
+}
+
+std::string GenerateSum(i32 size)
+{
+	return Repeat("a + ", size - 1) + "a";
+}
+
+std::string GenerateParens(i32 size)
+{
+	return Repeat("(", size) + "a" + Repeat(")", size);
+}
+
+std::string GenerateComparisons(i32 size)
+{
+	return Repeat("a < b > ", size) + "c";
+}
+
+std::string GenerateSpecializations(i32 size)
+{
+	return Repeat("f<", size) + "a" + Repeat(">", size) + "(x)";
+}
+
+std::string GenerateCasts(i32 size)
+{
+	return Repeat("(T)", size) + "(x)";
+}
+
+std::string GenerateMixed(i32 size)
+{
+	GeneratorOptions options;
+	options.size = size;
+	options.depth = 0;
+	options.ambiguity = 0.25;
+
+	return ExpressionGenerator(options, 1).Generate();
+}
+
+struct Family
+{
+	const char* name;
+	std::string(*generate)(i32 size);
+
+	// highest growth exponent expected of steps and memory: linear for
+	// unambiguous input, at most cubic for ambiguous input.
+	double bound;
+
+	// highest growth exponent expected of time.
+	double timeBound;
+};
+
+// Steps and memory are bound by the complexity of the grammar alone. Time
+// carries one more power for the nested families, as FindLeaf walks the
+// frames from the root on every step, and those nest as deep as the input.
+const Family Families[] = {
+	{ "sum",             GenerateSum,             1, 1 },
+	{ "parens",          GenerateParens,          1, 2 },
+	{ "comparisons",     GenerateComparisons,     3, 3 },
+	{ "specializations", GenerateSpecializations, 3, 4 },
+	{ "casts",           GenerateCasts,           3, 4 },
+	{ "mixed",           GenerateMixed,           3, 3 },
+};
+
+struct Sample
+{
+	double size;
+	double nanoseconds;
+	double steps;
+	double bytes;
+};
+
+// Least squares slope of log(y) over log(size), ignoring empty samples.
+double FitExponent(const std::vector<Sample>& samples, double Sample::* y)
+{
+	double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+	for (const Sample& sample : samples)
+	{
+		if (sample.*y <= 0)
+			continue;
+
+		double lx = std::log(sample.size);
+		double ly = std::log(sample.*y);
+
+		n += 1;
+		sx += lx;
+		sy += ly;
+		sxx += lx * lx;
+		sxy += lx * ly;
+	}
+
+	double d = n * sxx - sx * sx;
+	return n >= 2 && d != 0 ? (n * sxy - sx * sy) / d : 0;
+}
+
+// Times the parse of a family member, failing if it is rejected or abandoned.
+bool Measure(const Family& family, i32 size, i32 repeats, Sample* sample)
+{
+	std::string source = family.generate(size);
+
+	ParseOptions options;
+	ParseStats stats;
+	options.stats = &stats;
+
+	u64 best = ~(u64)0;
+	for (i32 repeat = 0; repeat < std::max(repeats, 1); ++repeat)
+	{
+		auto start = Clock::now();
+		SyntaxTree tree = ParseExpression(source, options);
+		best = std::min(best, (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+		if (tree.GetStatus() != ParseStatus::Complete || tree.GetRoot() == nullptr)
+			return false;
+	}
+
+	*sample = { (double)size, (double)best, (double)stats.steps, (double)(stats.peakCoroutineBytes + stats.treeBytes) };
+	return true;
+}
+
+} // namespace
+
+bool CoroGLL::Bench::RunScaling(const ScalingOptions& options)
+{
+	bool withinBounds = true;
+
+	std::cout << std::left << std::setw(18) << "family" << std::right
+		<< std::setw(8) << "bound"
+		<< std::setw(8) << "steps"
+		<< std::setw(8) << "memory"
+		<< std::setw(12) << "time bound"
+		<< std::setw(8) << "time"
+		<< std::setw(14) << "steps at max" << '\n';
+
+	for (const Family& family : Families)
+	{
+		std::vector<Sample> samples;
+		i32 failures = 0;
+
+		for (i32 size = std::max(options.minSize, 1); size <= options.maxSize; size *= 2)
+		{
+			//a failed parse stops early, its exponents would be meaningless
+			if (Sample sample; Measure(family, size, options.repeats, &sample))
+				samples.push_back(sample);
+			else ++failures;
+		}
+
+		double time = FitExponent(samples, &Sample::nanoseconds);
+		double steps = FitExponent(samples, &Sample::steps);
+		double memory = FitExponent(samples, &Sample::bytes);
+
+		bool timeFlagged = time > family.timeBound + options.tolerance;
+		bool stepsFlagged = steps > family.bound + options.tolerance;
+		bool memoryFlagged = memory > family.bound + options.tolerance;
+		if (timeFlagged || stepsFlagged || memoryFlagged || failures != 0)
+			withinBounds = false;
+
+		std::cout << std::left << std::setw(18) << family.name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(8) << family.bound
+			<< std::setw(8) << steps
+			<< std::setw(8) << memory
+			<< std::setw(12) << family.timeBound
+			<< std::setw(8) << time
+			<< std::setw(14) << (samples.empty() ? 0 : (u64)samples.back().steps)
+			<< (timeFlagged ? "  time exceeds bound" : "")
+			<< (stepsFlagged ? "  steps exceed bound" : "")
+			<< (memoryFlagged ? "  memory exceeds bound" : "")
+			<< (failures != 0 ? "  failed parses" : "") << '\n';
+	}
+
+	return withinBounds;
+}
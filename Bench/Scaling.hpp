@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace CoroGLL::Bench {
+
+struct ScalingOptions
+{
+	// sizes double from the minimum up to the maximum.
+	i32 minSize = 16;
+	i32 maxSize = 256;
+
+	// each parse is timed this many times, keeping the fastest.
+	i32 repeats = 3;
+
+	// slack allowed on the expected exponent before a family is flagged.
+	double tolerance = 0.3;
+};
+
+// Parses each corpus family at increasing sizes and fits the growth exponents
+// of time, steps and memory. Returns whether all families parsed and stayed
+// within bounds.
+bool RunScaling(const ScalingOptions& options);
+
+} // namespace CoroGLL::Bench
@@ -0,0 +1,144 @@
+#include "HotspotProfiler.hpp"
+#include "Core/Debug.hpp"
+
+#include <algorithm>
+#include <string>
+
+using namespace CoroGLL;
+
+namespace {
+
+std::string_view GetLine(std::string_view text, i32 lineIndex)
+{
+	std::size_t first = 0;
+	for (; lineIndex > 0; --lineIndex)
+	{
+		first = text.find('\n', first);
+		if (first == std::string_view::npos)
+			return {};
+		++first;
+	}
+
+	std::size_t last = text.find('\n', first);
+	if (last == std::string_view::npos)
+		last = text.size();
+
+	if (last > first && text[last - 1] == '\r')
+		--last;
+
+	return text.substr(first, last - first);
+}
+
+} // namespace
+
+void CoroGLL::HotspotProfiler::OnEvent(const ParseEvent& event)
+{
+	switch (event.kind)
+	{
+	case ParseEventKind::CreateFrame:
+		++GetHotspot(event.tokenIndex).frames;
+		break;
+
+	case ParseEventKind::MemoHit:
+		++GetHotspot(event.tokenIndex).memoHits;
+		break;
+
+	case ParseEventKind::CreateFork:
+		//includes the initial fork of each frame, which is subtracted on report
+		++GetHotspot(event.tokenIndex).forks;
+		break;
+
+	case ParseEventKind::Resume:
+		++GetHotspot(event.tokenIndex).steps;
+		m_resumeTokenIndex = event.tokenIndex;
+		m_resumeStart = Clock::now();
+		break;
+
+	case ParseEventKind::Suspend_Fork:
+	case ParseEventKind::Suspend_Parse:
+	case ParseEventKind::Suspend_Error:
+	case ParseEventKind::Suspend_Commit:
+	case ParseEventKind::Suspend_Join:
+	case ParseEventKind::Exit_Ready:
+	case ParseEventKind::Exit_Tail:
+		GetHotspot(m_resumeTokenIndex).nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_resumeStart).count();
+		break;
+
+	default:
+		break;
+	}
+}
+
+std::vector<TokenHotspot> CoroGLL::HotspotProfiler::GetHotspots() const
+{
+	std::vector<TokenHotspot> hotspots;
+	for (const TokenHotspot& hotspot : m_hotspots)
+	{
+		if (hotspot.frames != 0 || hotspot.memoHits != 0 || hotspot.forks != 0 || hotspot.steps != 0)
+		{
+			hotspots.push_back(hotspot);
+
+			TokenHotspot& back = hotspots.back();
+			back.forks -= std::min(back.forks, back.frames);
+		}
+	}
+
+	std::stable_sort(hotspots.begin(), hotspots.end(), [](const TokenHotspot& a, const TokenHotspot& b)
+	{
+		return a.forks != b.forks ? a.forks > b.forks : a.steps > b.steps;
+	});
+
+	return hotspots;
+}
+
+void CoroGLL::HotspotProfiler::WriteReport(std::ostream& os, std::string_view text, const TokenList& tokens, i32 maxCount) const
+{
+	std::vector<TokenHotspot> hotspots = GetHotspots();
+	if ((i32)hotspots.size() > maxCount)
+		hotspots.resize(maxCount);
+
+	for (const TokenHotspot& hotspot : hotspots)
+	{
+		Assert(hotspot.tokenIndex < tokens.Count());
+		Ast::SourcePos pos = tokens[hotspot.tokenIndex]->Pos();
+
+		os << pos.Line() + 1 << ':' << pos.Column() + 1
+			<< "\ttoken " << hotspot.tokenIndex
+			<< "\tforks " << hotspot.forks
+			<< "\tframes " << hotspot.frames
+			<< "\tmemo hits " << hotspot.memoHits
+			<< "\tsteps " << hotspot.steps
+			<< "\ttime " << hotspot.nanoseconds / 1000 << "us\n";
+
+		std::string_view line = GetLine(text, pos.Line());
+
+		//keep tabs so that the marker lines up with the token
+		std::string marker;
+		for (i32 index = 0; index < pos.Column() && index < (i32)line.size(); ++index)
+			marker.push_back(line[index] == '\t' ? '\t' : ' ');
+
+		os << '\t' << line << '\n';
+		os << '\t' << marker << "^\n";
+	}
+}
+
+void CoroGLL::HotspotProfiler::Clear()
+{
+	m_hotspots.clear();
+}
+
+TokenHotspot& CoroGLL::HotspotProfiler::GetHotspot(i32 tokenIndex)
+{
+	Assert(tokenIndex >= 0);
+
+	if (tokenIndex >= (i32)m_hotspots.size())
+	{
+		i32 index = m_hotspots.size();
+		m_hotspots.resize(tokenIndex + 1);
+
+		for (; index <= tokenIndex; ++index)
+			m_hotspots[index].tokenIndex = index;
+	}
+
+	return m_hotspots[tokenIndex];
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Lexer.hpp"
+#include "ParseObserver.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace CoroGLL {
+
+// Work done by the engine at a token of the input.
+struct TokenHotspot
+{
+	i32 tokenIndex = 0;
+
+	// memo frames created and reused starting at the token.
+	u64 frames = 0;
+	u64 memoHits = 0;
+
+	// forks created while positioned at the token, not counting the
+	// initial fork of each frame. this is where the ambiguities are.
+	u64 forks = 0;
+
+	// resumptions of forks positioned at the token, and the time they took.
+	u64 steps = 0;
+	u64 nanoseconds = 0;
+};
+
+// Aggregates the events of a parse by the token at which they happened.
+class HotspotProfiler final : public ParseObserver
+{
+public:
+	virtual void OnEvent(const ParseEvent& event) override;
+
+	// Tokens at which any work was done, sorted by descending forks, then steps.
+	std::vector<TokenHotspot> GetHotspots() const;
+
+	// Writes the worst hotspots, each with its position and the source line
+	// marked at the token. The tokens must be those of the observed parse.
+	void WriteReport(std::ostream& os, std::string_view text, const TokenList& tokens, i32 maxCount = 10) const;
+
+	void Clear();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	TokenHotspot& GetHotspot(i32 tokenIndex);
+
+	std::vector<TokenHotspot> m_hotspots;
+
+	i32 m_resumeTokenIndex = 0;
+	Clock::time_point m_resumeStart;
+};
+
+} // namespace CoroGLL
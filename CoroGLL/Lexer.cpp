@@ -1225,14 +1225,16 @@ private:
 
 struct CoroGLL::Private::TokenListAttorney
 {
-	static TokenList CreateTokenList(std::vector<Ast::Token*>&& tokens, SyntaxTreeContext&& treeContext)
+	static TokenList CreateTokenList(std::vector<Ast::Token*>&& tokens, std::vector<i32>&& brackets, SyntaxTreeContext&& treeContext)
 	{
-		return TokenList(std::move(tokens), std::move(treeContext));
+		return TokenList(std::move(tokens), std::move(brackets), std::move(treeContext));
 	}
 };
 
-std::vector<CoroGLL::Ast::Token*> CoroGLL::Private::Lex(std::string_view text, SyntaxTreeContext* treeContext)
+std::vector<CoroGLL::Ast::Token*> CoroGLL::Private::Lex(std::string_view text, SyntaxTreeContext* treeContext, ParseStats* stats)
 {
+	StatsTimer timer(stats != nullptr ? &stats->lexNanoseconds : nullptr);
+
 	std::vector<Ast::Token*> tokens;
 	Lexer lexer(text, treeContext);
 
@@ -1245,13 +1247,92 @@ std::vector<CoroGLL::Ast::Token*> CoroGLL::Private::Lex(std::string_view text, S
 			break;
 	}
 
+	if (EnableParseStats && stats != nullptr)
+		stats->tokens += tokens.size();
+
 	return tokens;
 }
 
+std::vector<CoroGLL::i32> CoroGLL::Private::MatchBrackets(Span<Ast::Token* const> tokens, ParseStats* stats)
+{
+	StatsTimer timer(stats != nullptr ? &stats->matchNanoseconds : nullptr);
+
+	std::vector<i32> brackets(tokens.Size());
+	std::vector<i32> openers;
+
+	for (i32 index = 0; index < tokens.Size(); ++index)
+	{
+		brackets[index] = index;
+
+		SyntaxKind openKind;
+		switch (tokens[index]->Kind())
+		{
+		case SyntaxKind::LParenSymbol:
+		case SyntaxKind::LBrackSymbol:
+		case SyntaxKind::LAngleSymbol:
+			openers.push_back(index);
+			continue;
+
+		case SyntaxKind::RParenSymbol:
+			openKind = SyntaxKind::LParenSymbol;
+			break;
+
+		case SyntaxKind::RBrackSymbol:
+			openKind = SyntaxKind::LBrackSymbol;
+			break;
+
+		case SyntaxKind::RAngleSymbol:
+			if (!openers.empty() && tokens[openers.back()]->Kind() == SyntaxKind::LAngleSymbol)
+			{
+				i32 openIndex = openers.back();
+				openers.pop_back();
+
+				brackets[openIndex] = index;
+				brackets[index] = openIndex;
+			}
+			continue;
+
+		default:
+			continue;
+		}
+
+		//angle brackets still open at this point are less-than operators
+		while (!openers.empty() && tokens[openers.back()]->Kind() == SyntaxKind::LAngleSymbol)
+			openers.pop_back();
+
+		if (!openers.empty() && tokens[openers.back()]->Kind() == openKind)
+		{
+			i32 openIndex = openers.back();
+			openers.pop_back();
+
+			brackets[openIndex] = index;
+			brackets[index] = openIndex;
+		}
+	}
+
+	return brackets;
+}
+
 CoroGLL::TokenList CoroGLL::Lex(std::string_view text)
 {
+	return Lex(text, nullptr);
+}
+
+CoroGLL::TokenList CoroGLL::Lex(std::string_view text, ParseStats* stats)
+{
+	if (EnableParseStats && stats != nullptr)
+		*stats = ParseStats();
+
 	SyntaxTreeContext treeContext;
-	std::vector<Ast::Token*> tokens = Lex(text, &treeContext);
+	std::vector<Ast::Token*> tokens = Lex(text, &treeContext, stats);
+	std::vector<i32> brackets = MatchBrackets(Span<Ast::Token* const>(tokens.data(), tokens.size()), stats);
+
+	if (EnableParseStats && stats != nullptr)
+	{
+		stats->treeBytes = treeContext.AllocatedBytes();
+		stats->treeAllocations = treeContext.AllocationCount();
+	}
+
 	return Private::TokenListAttorney::CreateTokenList(
-		std::move(tokens), std::move(treeContext));
+		std::move(tokens), std::move(brackets), std::move(treeContext));
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ParseStats.hpp"
 #include "SyntaxTree.hpp"
 #include "Syntax/Token.hpp"
 
@@ -11,7 +12,13 @@ namespace CoroGLL::Private {
 
 struct TokenListAttorney;
 
-std::vector<Ast::Token*> Lex(std::string_view text, SyntaxTreeContext* treeContext);
+// The stats, if any, receive the token count and the time spent.
+std::vector<Ast::Token*> Lex(std::string_view text, SyntaxTreeContext* treeContext, ParseStats* stats = nullptr);
+
+// Maps the index of each bracket token to the index of its matching bracket.
+// Unmatched brackets and other tokens map to their own index.
+// Angle brackets are matched as candidates only and never across parentheses or brackets.
+std::vector<i32> MatchBrackets(Span<Ast::Token* const> tokens, ParseStats* stats = nullptr);
 
 } // namespace CoroGLL::Private
 
@@ -34,14 +41,20 @@ public:
 	{
 		return Span<Ast::Token* const>(m_tokens.data(), m_tokens.size());
 	}
+
+	i32 MatchingToken(i32 index) const
+	{
+		return m_brackets[index];
+	}
 	
 private:
-	TokenList(std::vector<Ast::Token*> tokens, Private::SyntaxTreeContext treeContext)
-		: m_tokens(std::move(tokens)), m_treeContext(std::move(treeContext))
+	TokenList(std::vector<Ast::Token*> tokens, std::vector<i32> brackets, Private::SyntaxTreeContext treeContext)
+		: m_tokens(std::move(tokens)), m_brackets(std::move(brackets)), m_treeContext(std::move(treeContext))
 	{
 	}
 
 	std::vector<Ast::Token*> m_tokens;
+	std::vector<i32> m_brackets;
 	Private::SyntaxTreeContext m_treeContext;
 
 	friend struct Private::TokenListAttorney;
@@ -58,5 +71,6 @@ private:
 };
 
 TokenList Lex(std::string_view text);
+TokenList Lex(std::string_view text, ParseStats* stats);
 
 } // namespace CoroGLL
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Syntax/Expression.hpp"
+#include "Syntax/SyntaxKind.hpp"
+#include "Syntax/SyntaxKindSet.hpp"
+#include "Core/Types.hpp"
+
+#include <initializer_list>
+
+//    symbol          operator                  precedence      associativity
+#define COROGLL_BINARY_OPERATOR_SYMBOL(X)                                       \
+	X( Add,           Addition,                 Additive,       Left  )        \
+	X( And,           And,                      And,            Left  )        \
+	X( Assign,        Assignment,               Assignment,     Right )        \
+	X( AssignAdd,     AdditionAssignment,       Assignment,     Right )        \
+	X( AssignAnd,     AndAssignment,            Assignment,     Right )        \
+	X( AssignDiv,     DivisionAssignment,       Assignment,     Right )        \
+	X( AssignLhs,     LeftShiftAssignment,      Assignment,     Right )        \
+	X( AssignMod,     ModuloAssignment,         Assignment,     Right )        \
+	X( AssignMul,     MultiplicationAssignment, Assignment,     Right )        \
+	X( AssignNot,     NotAssignment,            Assignment,     Right )        \
+	X( AssignOr,      OrAssignment,             Assignment,     Right )        \
+	X( AssignSub,     SubtractionAssignment,    Assignment,     Right )        \
+	X( AssignXor,     XorAssignment,            Assignment,     Right )        \
+	X( Coalescing,    Coalescing,               Coalescing,     Right )        \
+	X( Div,           Division,                 Multiplicative, Left  )        \
+	X( Equal,         Equal,                    Equality,       Left  )        \
+	X( Greater,       GreaterThan,              Relation,       Left  )        \
+	X( LeftShift,     LeftShift,                Shift,          Left  )        \
+	X( Less,          LessThan,                 Relation,       Left  )        \
+	X( LessOrEqual,   LessThanOrEqual,          Relation,       Left  )        \
+	X( LogicalAnd,    LogicalAnd,               LogicalAnd,     Left  )        \
+	X( LogicalOr,     LogicalOr,                LogicalOr,      Left  )        \
+	X( Mod,           Modulo,                   Multiplicative, Left  )        \
+	X( Mul,           Multiplication,           Multiplicative, Left  )        \
+	X( NotEqual,      NotEqual,                 Equality,       Left  )        \
+	X( Or,            Or,                       Or,             Left  )        \
+	X( Sub,           Subtraction,              Additive,       Left  )        \
+	X( Xor,           Xor,                      Xor,            Left  )        \
+
+// The symbol sequences >>, >>= and >= are not lexed as single tokens, as >
+// may also close a specialization. The parser combines them.
+//    symbol           operator                  precedence      associativity
+#define COROGLL_BINARY_OPERATOR_COMBINED_SYMBOL(X)                               \
+	X( AssignRhs,      RightShiftAssignment,     Assignment,     Right )        \
+	X( GreaterOrEqual, GreaterThanOrEqual,       Relation,       Left  )        \
+	X( RightShift,     RightShift,               Shift,          Left  )        \
+
+namespace CoroGLL {
+
+enum class CombinedSymbol : u8
+{
+#define COROGLL_X(s, o, p, a) s,
+	COROGLL_BINARY_OPERATOR_COMBINED_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+};
+
+inline constexpr u32 CombinedSymbolCount = 0
+#define COROGLL_X(s, o, p, a) + 1
+	COROGLL_BINARY_OPERATOR_COMBINED_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+;
+
+enum class Precedence : u8
+{
+	Expression = 0,
+
+	Assignment,
+	Ternary,
+	Coalescing,
+	LogicalOr,
+	LogicalAnd,
+	Equality,
+	Relation,
+	Or,
+	Xor,
+	And,
+	Shift,
+	Additive,
+	Multiplicative,
+	UnaryPrefix, //TODO: separate definite unary prefix and potential unary prefix?
+	TypeCast,
+	UnaryPostfix,
+	Invoke,
+	Access,
+	Primary,
+};
+
+enum class Associativity : u8
+{
+	Left,
+	Right,
+};
+
+struct OperatorInfo
+{
+	Ast::BinaryOperator binaryOperator;
+	Precedence precedence;
+	Associativity associativity;
+
+	// symbols which are not binary operators have the lowest precedence.
+	constexpr bool IsBinaryOperator() const
+	{
+		return precedence != Precedence::Expression;
+	}
+};
+
+// Binary operators indexed by the kind of their symbol token, and by the
+// combined symbol for those the parser assembles from several tokens.
+class OperatorTable
+{
+public:
+	struct Entry
+	{
+		Ast::SyntaxKind symbol;
+		OperatorInfo info;
+	};
+
+	struct CombinedEntry
+	{
+		CombinedSymbol symbol;
+		OperatorInfo info;
+	};
+
+	constexpr OperatorTable()
+		: m_operators{}, m_combinedOperators{}
+	{
+	}
+
+	constexpr OperatorTable(std::initializer_list<Entry> entries, std::initializer_list<CombinedEntry> combinedEntries = {})
+		: m_operators{}, m_combinedOperators{}
+	{
+		for (const Entry& entry : entries)
+			Set(entry.symbol, entry.info);
+
+		for (const CombinedEntry& entry : combinedEntries)
+			Set(entry.symbol, entry.info);
+	}
+
+	constexpr void Set(Ast::SyntaxKind symbol, OperatorInfo info)
+	{
+		m_operators[(u32)symbol] = info;
+	}
+
+	constexpr void Set(CombinedSymbol symbol, OperatorInfo info)
+	{
+		m_combinedOperators[(u32)symbol] = info;
+	}
+
+	constexpr void Remove(Ast::SyntaxKind symbol)
+	{
+		m_operators[(u32)symbol] = OperatorInfo{};
+	}
+
+	constexpr void Remove(CombinedSymbol symbol)
+	{
+		m_combinedOperators[(u32)symbol] = OperatorInfo{};
+	}
+
+	constexpr const OperatorInfo& Lookup(Ast::SyntaxKind symbol) const
+	{
+		return m_operators[(u32)symbol];
+	}
+
+	constexpr const OperatorInfo& Lookup(CombinedSymbol symbol) const
+	{
+		return m_combinedOperators[(u32)symbol];
+	}
+
+private:
+	OperatorInfo m_operators[Ast::SyntaxKindCount];
+	OperatorInfo m_combinedOperators[CombinedSymbolCount];
+};
+
+inline constexpr OperatorTable DefaultOperatorTable(
+	{
+#define COROGLL_X(s, o, p, a) { Ast::SyntaxKind::s ## Symbol, { Ast::BinaryOperator::o, Precedence::p, Associativity::a } },
+		COROGLL_BINARY_OPERATOR_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+	},
+	{
+#define COROGLL_X(s, o, p, a) { CombinedSymbol::s, { Ast::BinaryOperator::o, Precedence::p, Associativity::a } },
+		COROGLL_BINARY_OPERATOR_COMBINED_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+	});
+
+} // namespace CoroGLL
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <string_view>
+
+#define COROGLL_PARSE_EVENT(X) \
+	X( CreateFrame   )         \
+	X( MemoHit       )         \
+	X( ReadyFrame    )         \
+	X( FailFrame     )         \
+	X( DiscardFrame  )         \
+	X( CreateFork    )         \
+	X( TerminateFork )         \
+	X( Resume        )         \
+	X( Suspend_Fork  )         \
+	X( Suspend_Parse )         \
+	X( Suspend_Error )         \
+	X( Suspend_Commit )        \
+	X( Suspend_Join  )         \
+	X( Exit_Ready    )         \
+	X( Exit_Tail     )         \
+
+namespace CoroGLL {
+
+enum class ParseEventKind : u8
+{
+#define COROGLL_X(n) n ,
+	COROGLL_PARSE_EVENT(COROGLL_X)
+#undef COROGLL_X
+};
+
+inline std::string_view ToString(ParseEventKind kind)
+{
+	static constexpr std::string_view strings[] = {
+#define COROGLL_X(n) #n ,
+		COROGLL_PARSE_EVENT(COROGLL_X)
+#undef COROGLL_X
+	};
+
+	return strings[(u32)kind];
+}
+
+// Identity of a grammar rule function. See GetRuleName.
+typedef void(*ParseRule)();
+
+// Scheduler activity reported to a ParseObserver.
+// Frames and forks are numbered from one in order of creation, zero meaning none.
+struct ParseEvent
+{
+	ParseEventKind kind;
+	i32 tokenIndex;
+	u32 frame;
+	u32 fork;
+	ParseRule rule;
+
+	// size of the coroutine frame of the fork, or zero for frame events.
+	u32 coroutineBytes;
+};
+
+// Receives every event of the parses it is given to through ParseOptions.
+// Called synchronously from the engine, so it should be quick.
+class ParseObserver
+{
+public:
+	virtual void OnEvent(const ParseEvent& event) = 0;
+
+protected:
+	~ParseObserver() = default;
+};
+
+} // namespace CoroGLL
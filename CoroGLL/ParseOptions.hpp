@@ -0,0 +1,117 @@
+#pragma once
+
+#include "OperatorTable.hpp"
+#include "ParseObserver.hpp"
+#include "ParseStats.hpp"
+#include "Syntax/Token.hpp"
+
+#include <atomic>
+
+namespace CoroGLL {
+
+enum class NameKind
+{
+	Unknown,
+
+	Value,
+	Type,
+	Template,
+};
+
+enum class EngineMode
+{
+	// all alternatives of a fork are explored side by side.
+	Generalized,
+
+	// alternatives of a fork are tried one at a time, in order, moving on to
+	// the next only when the previous fails. completed frames are memoized for
+	// the whole parse. produces the same trees as Generalized.
+	OrderedChoice,
+};
+
+// Selects the fork resumed at each step of the engine.
+enum class SchedulingPolicy
+{
+	// the fork at the lowest token index. keeps all forks in step with each
+	// other, which allows memo frames to be dropped as the parse advances.
+	LeastAdvanced,
+
+	// the most preferred fork, exploring the first alternative of each fork to the end.
+	DepthFirst,
+
+	// the least advanced fork past the position of the previous step, wrapping around.
+	RoundRobin,
+};
+
+// Semantic knowledge supplied by the user. Consulted by the grammar before
+// forking on an ambiguity that can be resolved by knowing what a name denotes.
+class NameOracle
+{
+public:
+	virtual NameKind Classify(Ast::WordToken* nameToken) = 0;
+
+protected:
+	~NameOracle() = default;
+};
+
+// Flag for abandoning a parse, which may be raised from any thread.
+// The engine checks it before every step.
+class CancellationToken
+{
+public:
+	void Cancel()
+	{
+		m_cancelled.store(true, std::memory_order_relaxed);
+	}
+
+	bool IsCancelled() const
+	{
+		return m_cancelled.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<bool> m_cancelled = false;
+};
+
+// Limits on the resources a single parse may use, or zero for no limit.
+// A parse exceeding any of them is abandoned without a tree.
+struct ParseBudget
+{
+	u64 maxSteps = 0;
+	u64 maxLiveFrames = 0;
+	u64 maxCoroutineBytes = 0;
+	u64 maxArenaBytes = 0;
+};
+
+struct ParseOptions
+{
+	EngineMode engineMode = EngineMode::Generalized;
+	SchedulingPolicy schedulingPolicy = SchedulingPolicy::LeastAdvanced;
+
+	// limits on the number of forks alive at the same time, or zero for no limit.
+	// maxForksPerFrame drops the least preferred forks of a frame beyond the limit.
+	// maxLiveForks bounds the forks of all frames together, the root fork included:
+	// once it is reached, no further alternatives are forked and a fork needing a
+	// frame that is not yet memoized fails instead of creating it. Forks already
+	// alive are never evicted. Either limit makes the parse Truncated when it drops
+	// anything.
+	i32 maxForksPerFrame = 0;
+	i32 maxLiveForks = 0;
+
+	ParseBudget budget;
+
+	const CancellationToken* cancellation = nullptr;
+
+	NameOracle* nameOracle = nullptr;
+
+	// binary operators recognized by the expression grammar.
+	const OperatorTable* operatorTable = &DefaultOperatorTable;
+
+	// receives the counters of the parse, if set.
+	ParseStats* stats = nullptr;
+
+	// receives the scheduler events of the parse, if set.
+	ParseObserver* observer = nullptr;
+};
+
+} // namespace CoroGLL
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <chrono>
+
+// Set to zero to compile out the counters and timers which only feed ParseStats.
+// Counters also used to enforce limits and budgets are kept regardless.
+#ifndef COROGLL_PARSE_STATS
+#	define COROGLL_PARSE_STATS 1
+#endif
+
+namespace CoroGLL {
+
+inline constexpr bool EnableParseStats = COROGLL_PARSE_STATS != 0;
+
+// Counters describing the work done during a parse.
+struct ParseStats
+{
+	// number of tokens produced by the lexer, including the end of file token.
+	u64 tokens = 0;
+
+	// number of times a fork was resumed.
+	u64 steps = 0;
+
+	// number of memo frames created, one for each memo miss.
+	u64 frames = 0;
+
+	// number of parse requests answered by an existing memo frame.
+	u64 memoHits = 0;
+
+	// number of forks created, including the initial fork of each frame.
+	u64 forks = 0;
+
+	// number of forks abandoned before running to completion.
+	u64 forksTerminated = 0;
+
+	// number of coroutine frame bytes copied when forking.
+	u64 forkBytesCopied = 0;
+
+	// maximum number of forks alive at the same time.
+	u64 peakLiveForks = 0;
+
+	// maximum number of bytes held by coroutine frames at the same time.
+	u64 peakCoroutineBytes = 0;
+
+	// number of bytes allocated for tokens and syntax nodes.
+	u64 treeBytes = 0;
+
+	// number of allocations made for tokens and syntax nodes.
+	u64 treeAllocations = 0;
+
+	// time spent lexing, matching brackets and parsing, in nanoseconds.
+	// syntax nodes are created by the grammar as it runs, so building the
+	// tree is part of parsing and is reflected in treeBytes instead.
+	u64 lexNanoseconds = 0;
+	u64 matchNanoseconds = 0;
+	u64 parseNanoseconds = 0;
+};
+
+} // namespace CoroGLL
+
+namespace CoroGLL::Private {
+
+// Adds the time elapsed during its lifetime to a ParseStats timer, if any.
+class StatsTimer
+{
+public:
+	explicit StatsTimer(u64* nanoseconds)
+		: m_nanoseconds(EnableParseStats ? nanoseconds : nullptr)
+	{
+		if (m_nanoseconds != nullptr)
+			m_start = std::chrono::steady_clock::now();
+	}
+
+	StatsTimer(const StatsTimer&) = delete;
+	StatsTimer& operator=(const StatsTimer&) = delete;
+
+	~StatsTimer()
+	{
+		if (m_nanoseconds != nullptr)
+			*m_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+private:
+	u64* m_nanoseconds;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace CoroGLL::Private
@@ -0,0 +1,106 @@
+#include "ParseTracer.hpp"
+#include "Parser.hpp"
+#include "Core/Debug.hpp"
+
+#include <iomanip>
+#include <unordered_set>
+
+using namespace CoroGLL;
+
+namespace {
+
+void WriteTimestamp(std::ostream& os, u64 nanoseconds)
+{
+	//microseconds, with the nanoseconds as fraction
+	os << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+} // namespace
+
+CoroGLL::ParseTracer::ParseTracer(i32 capacity)
+	: m_start(std::chrono::steady_clock::now())
+{
+	Assert(capacity > 0);
+	m_records.reserve(capacity);
+}
+
+void CoroGLL::ParseTracer::OnEvent(const ParseEvent& event)
+{
+	Record record = { event, (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count() };
+
+	if (m_records.size() < m_records.capacity())
+		m_records.push_back(record);
+	else m_records[m_total % m_records.size()] = record;
+
+	++m_total;
+}
+
+i32 CoroGLL::ParseTracer::Count() const
+{
+	return m_records.size();
+}
+
+u64 CoroGLL::ParseTracer::Dropped() const
+{
+	return m_total - m_records.size();
+}
+
+void CoroGLL::ParseTracer::Clear()
+{
+	m_records.clear();
+	m_total = 0;
+	m_start = std::chrono::steady_clock::now();
+}
+
+void CoroGLL::ParseTracer::WriteChromeTrace(std::ostream& os) const
+{
+	//forks with an open slice. the beginning of a slice may have been overwritten
+	std::unordered_set<u32> running;
+
+	os << "{\"traceEvents\":[";
+
+	const char* separator = "\n";
+	for (u64 index = Dropped(); index < m_total; ++index)
+	{
+		const Record& record = m_records[index % m_records.size()];
+		const ParseEvent& event = record.event;
+
+		switch (event.kind)
+		{
+		case ParseEventKind::Resume:
+			running.insert(event.fork);
+
+			os << separator << "{\"name\":\"" << GetRuleName(event.rule) << "\",\"ph\":\"B\"";
+			break;
+
+		case ParseEventKind::Suspend_Fork:
+		case ParseEventKind::Suspend_Parse:
+		case ParseEventKind::Suspend_Error:
+		case ParseEventKind::Suspend_Commit:
+		case ParseEventKind::Suspend_Join:
+		case ParseEventKind::Exit_Ready:
+		case ParseEventKind::Exit_Tail:
+			if (running.erase(event.fork) == 0)
+				continue;
+
+			os << separator << "{\"ph\":\"E\"";
+			break;
+
+		default:
+			os << separator << "{\"name\":\"" << ToString(event.kind) << "\",\"ph\":\"i\",\"s\":\"t\"";
+			break;
+		}
+
+		os << ",\"pid\":0,\"tid\":" << event.fork << ",\"ts\":";
+		WriteTimestamp(os, record.nanoseconds);
+
+		os << ",\"args\":{\"event\":\"" << ToString(event.kind)
+			<< "\",\"rule\":\"" << GetRuleName(event.rule)
+			<< "\",\"token\":" << event.tokenIndex
+			<< ",\"frame\":" << event.frame << "}}";
+
+		separator = ",\n";
+	}
+
+	os << "\n]}\n";
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ParseObserver.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace CoroGLL {
+
+// Records the most recent parse events in a ring buffer of fixed capacity.
+class ParseTracer final : public ParseObserver
+{
+public:
+	explicit ParseTracer(i32 capacity = 1 << 16);
+
+	virtual void OnEvent(const ParseEvent& event) override;
+
+	// Number of events held, at most the capacity.
+	i32 Count() const;
+
+	// Number of events overwritten since the last clear.
+	u64 Dropped() const;
+
+	void Clear();
+
+	// Writes the held events in the Chrome trace event format, viewable in
+	// chrome://tracing or Perfetto. Each fork is shown as a thread, with a
+	// slice for each resumption, named after the rule of its frame.
+	void WriteChromeTrace(std::ostream& os) const;
+
+private:
+	struct Record
+	{
+		ParseEvent event;
+		u64 nanoseconds;
+	};
+
+	std::vector<Record> m_records;
+	u64 m_total = 0;
+
+	std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace CoroGLL
@@ -2,8 +2,10 @@
 
 #include "Core/Types.hpp"
 #include "Lexer.hpp"
+#include "OperatorTable.hpp"
 #include "ParserCore.hpp"
 #include "Syntax/Expression.hpp"
+#include "Syntax/SyntaxKindSet.hpp"
 
 using namespace CoroGLL;
 using namespace CoroGLL::Ast;
@@ -12,6 +14,7 @@ namespace {
 
 using CoroGLL::Private::ParserCore::Result;
 using CoroGLL::Private::ParserCore::ParseContext;
+using CoroGLL::Private::ParserCore::ParseInfo;
 
 typedef ParseContext Ctx;
 
@@ -48,31 +51,41 @@ constexpr Flags operator~(Flags a)
 	return (Flags)(~((T)a));
 }
 
-enum class Precedence : i32
-{
-	Expression = 0,
-
-	Assignment,
-	Ternary,
-	Coalescing,
-	LogicalOr,
-	LogicalAnd,
-	Equality,
-	Relation,
-	Or,
-	Xor,
-	And,
-	Shift,
-	Additive,
-	Multiplicative,
-	UnaryPrefix, //TODO: separate definite unary prefix and potential unary prefix?
-	TypeCast,
-	UnaryPostfix,
-	Invoke,
-	Access,
-	Primary,
+constexpr SyntaxKindSet FirstOfWord = {
+#define COROGLL_X(n, s) SyntaxKind::n ## Keyword,
+	COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+	SyntaxKind::NameToken,
 };
 
+// tokens which may begin a primary expression in a type context.
+constexpr SyntaxKindSet FirstOfTypeExpression = FirstOfWord | SyntaxKindSet{
+	SyntaxKind::ScopeSymbol,
+	SyntaxKind::CharLiteralToken,
+	SyntaxKind::StringLiteralToken,
+	SyntaxKind::NumericLiteralToken,
+	SyntaxKind::DollarSymbol,
+};
+
+constexpr SyntaxKindSet FirstOfPrimaryExpression = FirstOfTypeExpression | SyntaxKindSet{
+	SyntaxKind::LParenSymbol,
+};
+
+constexpr SyntaxKindSet FirstOfUnaryPrefixOperator = {
+	SyntaxKind::AddSymbol,
+	SyntaxKind::AndSymbol,
+	SyntaxKind::AwaitKeyword,
+	SyntaxKind::DecrementSymbol,
+	SyntaxKind::MulSymbol,
+	SyntaxKind::NotSymbol,
+	SyntaxKind::IncrementSymbol,
+	SyntaxKind::LogicalNotSymbol,
+	SyntaxKind::SubSymbol,
+};
+
+constexpr SyntaxKindSet FirstOfUnaryExpression = FirstOfPrimaryExpression | FirstOfUnaryPrefixOperator;
+constexpr SyntaxKindSet FirstOfUnaryTypeExpression = FirstOfTypeExpression | FirstOfUnaryPrefixOperator;
+
 bool IsWordToken(SyntaxKind syntaxKind)
 {
 	switch (syntaxKind)
@@ -97,6 +110,83 @@ bool IsTypeExpression(Expression* expression)
 	return false;
 }
 
+NameKind ClassifyName(Ctx* ctx, WordToken* nameToken)
+{
+	if (NameOracle* oracle = ctx->Options().nameOracle)
+		return oracle->Classify(nameToken);
+	return NameKind::Unknown;
+}
+
+NameKind ClassifyName(Ctx* ctx, Expression* expression)
+{
+	if (expression->Kind() != SyntaxKind::WordExpression)
+		return NameKind::Unknown;
+	return ClassifyName(ctx, static_cast<WordExpression*>(expression)->nameToken);
+}
+
+// classifies the name in a parenthesized name, such as (x), at the current position.
+NameKind ClassifyParenthesizedName(Ctx* ctx)
+{
+	if (!IsWordToken(ctx->PeekToken(1)->Kind()) || ctx->PeekToken(2)->Kind() != SyntaxKind::RParenSymbol)
+		return NameKind::Unknown;
+	return ClassifyName(ctx, static_cast<WordToken*>(ctx->PeekToken(1)));
+}
+
+// looks up the binary operator at the current position in the operator table of the parse.
+// returns the number of tokens making up the operator through tokenCount.
+OperatorInfo PeekBinaryOperator(Ctx* ctx, i32* tokenCount)
+{
+	const OperatorTable& operatorTable = *ctx->Options().operatorTable;
+
+	Token* operatorToken = ctx->PeekToken();
+	OperatorInfo operatorInfo = operatorTable.Lookup(operatorToken->Kind());
+	*tokenCount = 1;
+
+	//TODO: combine tokens
+	if (operatorToken->Kind() == SyntaxKind::GreaterSymbol && operatorToken->TrailingTrivia().Size() == 0)
+	{
+		Token* operatorToken2 = ctx->PeekToken(1);
+		if (operatorToken2->LeadingTrivia().Size() != 0)
+			return operatorInfo;
+
+		OperatorInfo combinedInfo;
+		switch (operatorToken2->Kind())
+		{
+		case SyntaxKind::GreaterSymbol:
+			if (operatorToken2->TrailingTrivia().Size() == 0)
+			{
+				Token* operatorToken3 = ctx->PeekToken(2);
+				if (operatorToken3->Kind() == SyntaxKind::AssignSymbol && operatorToken3->LeadingTrivia().Size() == 0)
+				{
+					combinedInfo = operatorTable.Lookup(CombinedSymbol::AssignRhs);
+					if (combinedInfo.IsBinaryOperator())
+					{
+						*tokenCount = 3;
+						return combinedInfo;
+					}
+				}
+			}
+			combinedInfo = operatorTable.Lookup(CombinedSymbol::RightShift);
+			break;
+
+		case SyntaxKind::AssignSymbol:
+			combinedInfo = operatorTable.Lookup(CombinedSymbol::GreaterOrEqual);
+			break;
+
+		default:
+			return operatorInfo;
+		}
+
+		if (combinedInfo.IsBinaryOperator())
+		{
+			*tokenCount = 2;
+			return combinedInfo;
+		}
+	}
+
+	return operatorInfo;
+}
+
 namespace Rules {
 
 Result<Expression> ParseExpression(Ctx* ctx, Flags flags, Precedence precedence);
@@ -185,6 +275,23 @@ Result<Expression> ParseCastExpression(Ctx* ctx, Flags flags)
 	co_return ctx->CreateSyntax<CastExpression>(openToken, typeExpression, closeToken, expression);
 }
 
+bool PeekParensExpression(Ctx*)
+{
+	return true;
+}
+
+bool PeekCastExpression(Ctx* ctx)
+{
+	// the type of a cast expression is parsed in a type context, where a nested
+	// parenthesis can never be accepted.
+	if (!FirstOfUnaryTypeExpression.Contains(ctx->PeekToken(1)->Kind()))
+		return false;
+
+	// the closing parenthesis must be followed by the operand.
+	i32 closeIndex = ctx->PeekMatchingToken();
+	return closeIndex == 0 || FirstOfUnaryExpression.Contains(ctx->PeekToken(closeIndex + 1)->Kind());
+}
+
 Result<Expression> ParseLambdaExpression(Ctx* ctx, Flags flags)
 {
 	co_await ctx->SetError();
@@ -281,6 +388,16 @@ Result<Expression> ParseSpecializationExpression(Ctx* ctx, Flags flags, Expressi
 	co_return ctx->CreateSyntax<InvokeExpression>(InvokeOperator::Specialization, expression, openToken, arguments, closeToken);
 }
 
+bool PeekSpecializationExpression(Ctx* ctx)
+{
+	return ctx->PeekMatchingToken() != 0;
+}
+
+bool PeekLessThanExpression(Ctx*)
+{
+	return true;
+}
+
 Result<Expression> ParseScopeAccessExpression(Ctx* ctx, Flags flags, Expression* expression)
 {
 	Token* operatorToken = ctx->EatToken();
@@ -395,21 +512,34 @@ Result<Expression> ParsePrimaryExpression(Ctx* ctx, Flags flags)
 			Assert(false);
 		}
 
-		switch (co_await ctx->Fork(2))
+		switch (ClassifyParenthesizedName(ctx))
 		{
-		case 0: // parens expression
-			expression = co_await ctx->Parse(ParseParensExpression, flags);
-			break;
+		case NameKind::Value:
+			goto parseParensExpression;
 
-		case 1: // cast expression
-			expression = co_await ctx->Parse(ParseCastExpression, flags);
-			break;
+		case NameKind::Type:
+		case NameKind::Template:
+			goto parseCastExpression;
+		}
 
-	/*	case 2: // lambda expression
-			expression = co_await ctx->Parse(ParseLambdaExpression, flags);
-			break; */
+		switch (co_await ctx->Fork(PeekParensExpression, PeekCastExpression))
+		{
+		case 0: goto parseParensExpression;
+		case 1: goto parseCastExpression;
+	/*	case 2: goto parseLambdaExpression; */
 		}
+
+	parseParensExpression:
+		expression = co_await ctx->Parse(ParseParensExpression, flags);
+		break;
+
+	parseCastExpression:
+		expression = co_await ctx->Parse(ParseCastExpression, flags);
 		break;
+
+	/*parseLambdaExpression:
+		expression = co_await ctx->Parse(ParseLambdaExpression, flags);
+		break; */
 	}
 
 	while (true)
@@ -443,7 +573,17 @@ Result<Expression> ParsePrimaryExpression(Ctx* ctx, Flags flags)
 			if (!IsTypeExpression(expression))
 				goto parseLessThanExpression;
 
-			switch (co_await ctx->Fork(2))
+			switch (ClassifyName(ctx, expression))
+			{
+			case NameKind::Template:
+				goto parseSpecializationExpression;
+
+			case NameKind::Value:
+			case NameKind::Type:
+				goto parseLessThanExpression;
+			}
+
+			switch (co_await ctx->Fork(PeekSpecializationExpression, PeekLessThanExpression))
 			{
 			case 0: goto parseSpecializationExpression;
 			case 1: goto parseLessThanExpression;
@@ -570,247 +710,53 @@ Result<Expression> ParseUnaryExpression(Ctx* ctx, Flags flags)
 		co_return ctx->CreateSyntax<UnaryExpression>(unaryOperator, operatorToken, operand);
 	}
 
-	co_return co_await ctx->Parse(ParsePrimaryExpression, flags);
+	co_return ctx->TailParse(ParsePrimaryExpression, flags);
 }
 
 Result<Expression> ParseExpression(Ctx* ctx, Flags flags, Precedence precedence)
 {
+	struct Operation
+	{
+		Expression* leftOperand;
+		Token* operatorToken;
+		BinaryOperator binaryOperator;
+		Precedence precedence;
+	};
+
+	// operations awaiting their right operand. the whole operator chain is parsed
+	// in this frame; only the operands, where forks may occur, get frames of their own.
+	// this rule must therefore never fork, as its locals would be copied.
+	std::vector<Operation> operations;
+
 	Expression* leftOperand = co_await ctx->Parse(ParseUnaryExpression, flags);
 
 	if ((flags & Flags::TypeExpr) != Flags::None)
 		co_return leftOperand;
 
+parseOperator:
 	while (true)
 	{
-		BinaryOperator binaryOperator;
-		Precedence operatorPrecedence;
-		bool leftAssociative = true;
-
-		Token* operatorToken = ctx->PeekToken();
-		switch (operatorToken->Kind())
-		{
-		case SyntaxKind::AddSymbol:
-			binaryOperator = BinaryOperator::Addition;
-			operatorPrecedence = Precedence::Additive;
-			break;
-
-		case SyntaxKind::AndSymbol:
-			binaryOperator = BinaryOperator::And;
-			operatorPrecedence = Precedence::And;
-			break;
-
-		case SyntaxKind::AssignAddSymbol:
-			binaryOperator = BinaryOperator::AdditionAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignAndSymbol:
-			binaryOperator = BinaryOperator::AndAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignDivSymbol:
-			binaryOperator = BinaryOperator::DivisionAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignLhsSymbol:
-			binaryOperator = BinaryOperator::LeftShiftAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignModSymbol:
-			binaryOperator = BinaryOperator::ModuloAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
+		i32 operatorTokenCount;
+		OperatorInfo operatorInfo = PeekBinaryOperator(ctx, &operatorTokenCount);
 
-		case SyntaxKind::AssignMulSymbol:
-			binaryOperator = BinaryOperator::MultiplicationAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
+		if (!operatorInfo.IsBinaryOperator())
 			break;
 
-		case SyntaxKind::AssignNotSymbol:
-			binaryOperator = BinaryOperator::NotAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignOrSymbol:
-			binaryOperator = BinaryOperator::OrAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignSubSymbol:
-			binaryOperator = BinaryOperator::SubtractionAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::AssignSymbol:
-			binaryOperator = BinaryOperator::Assignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
+		if (operatorInfo.precedence < precedence)
 			break;
 
-		case SyntaxKind::AssignXorSymbol:
-			binaryOperator = BinaryOperator::XorAssignment;
-			operatorPrecedence = Precedence::Assignment;
-			leftAssociative = false;
+		if (operatorInfo.precedence == precedence && operatorInfo.associativity == Associativity::Left)
 			break;
 
-		case SyntaxKind::DivSymbol:
-			binaryOperator = BinaryOperator::Division;
-			operatorPrecedence = Precedence::Multiplicative;
-			break;
-
-		case SyntaxKind::EqualSymbol:
-			binaryOperator = BinaryOperator::Equal;
-			operatorPrecedence = Precedence::Equality;
-			break;
-
-		case SyntaxKind::GreaterSymbol:
-			if (operatorToken->TrailingTrivia().Size() == 0)
-			{
-				Token* operatorToken2 = ctx->PeekToken(1);
-				if (operatorToken2->LeadingTrivia().Size() != 0)
-					goto greaterThan;
-
-				switch (operatorToken2->Kind())
-				{
-				case SyntaxKind::GreaterSymbol:
-					if (operatorToken2->TrailingTrivia().Size() == 0)
-					{
-						Token* operatorToken3 = ctx->PeekToken(2);
-						if (operatorToken3->Kind() == SyntaxKind::AssignSymbol && operatorToken3->LeadingTrivia().Size() == 0)
-						{
-							binaryOperator = BinaryOperator::RightShiftAssignment;
-							operatorPrecedence = Precedence::Assignment;
-							leftAssociative = false;
-							break;
-						}
-					}
-					binaryOperator = BinaryOperator::RightShift;
-					operatorPrecedence = Precedence::Shift;
-					break;
-
-				case SyntaxKind::AssignSymbol:
-					binaryOperator = BinaryOperator::GreaterThanOrEqual;
-					operatorPrecedence = Precedence::Relation;
-					break;
-
-				default:
-					goto greaterThan;
-				}
-			}
-			else
-			{
-			greaterThan:
-				binaryOperator = BinaryOperator::GreaterThan;
-				operatorPrecedence = Precedence::Relation;
-			}
-			break;
-
-		case SyntaxKind::ModSymbol:
-			binaryOperator = BinaryOperator::Modulo;
-			operatorPrecedence = Precedence::Multiplicative;
-			break;
-
-		case SyntaxKind::MulSymbol:
-			binaryOperator = BinaryOperator::Multiplication;
-			operatorPrecedence = Precedence::Multiplicative;
-			break;
-
-		case SyntaxKind::NotEqualSymbol:
-			binaryOperator = BinaryOperator::NotEqual;
-			operatorPrecedence = Precedence::Equality;
-			break;
-
-		case SyntaxKind::CoalescingSymbol:
-			binaryOperator = BinaryOperator::Coalescing;
-			operatorPrecedence = Precedence::Coalescing;
-			leftAssociative = false;
-			break;
-
-		case SyntaxKind::LeftShiftSymbol:
-			binaryOperator = BinaryOperator::LeftShift;
-			operatorPrecedence = Precedence::Shift;
-			break;
-
-		case SyntaxKind::LessSymbol:
-			binaryOperator = BinaryOperator::LessThan;
-			operatorPrecedence = Precedence::Relation;
-			break;
-
-		case SyntaxKind::LessOrEqualSymbol:
-			binaryOperator = BinaryOperator::LessThanOrEqual;
-			operatorPrecedence = Precedence::Relation;
-			break;
-
-		case SyntaxKind::LogicalAndSymbol:
-			binaryOperator = BinaryOperator::LogicalAnd;
-			operatorPrecedence = Precedence::LogicalAnd;
-			break;
-
-		case SyntaxKind::LogicalOrSymbol:
-			binaryOperator = BinaryOperator::LogicalOr;
-			operatorPrecedence = Precedence::LogicalOr;
-			break;
-
-		case SyntaxKind::OrSymbol:
-			binaryOperator = BinaryOperator::Or;
-			operatorPrecedence = Precedence::Or;
-			break;
-
-		case SyntaxKind::SubSymbol:
-			binaryOperator = BinaryOperator::Subtraction;
-			operatorPrecedence = Precedence::Additive;
-			break;
-
-		case SyntaxKind::XorSymbol:
-			binaryOperator = BinaryOperator::Xor;
-			operatorPrecedence = Precedence::Xor;
-			break;
-
-		default:
-			goto exit;
-		}
-
-		if (operatorPrecedence < precedence)
-			break;
-
-		if (operatorPrecedence == precedence && leftAssociative)
-			break;
-
-		operatorToken = ctx->EatToken();
-
-		//TODO: combine tokens
-		switch (binaryOperator)
-		{
-		case BinaryOperator::RightShiftAssignment:
-			ctx->EatToken();
+		Token* operatorToken = ctx->EatToken();
+		for (i32 i = 1; i < operatorTokenCount; ++i)
 			ctx->EatToken();
-			break;
 
-		case BinaryOperator::GreaterThanOrEqual:
-			ctx->EatToken();
-			break;
+		operations.push_back({ leftOperand, operatorToken, operatorInfo.binaryOperator, precedence });
+		precedence = operatorInfo.precedence;
 
-		case BinaryOperator::RightShift:
-			ctx->EatToken();
-			break;
-		}
-
-		Expression* rightOperand = co_await ctx->Parse(ParseExpression, flags, operatorPrecedence);
-		leftOperand = ctx->CreateSyntax<BinaryExpression>(binaryOperator, leftOperand, operatorToken, rightOperand);
+		leftOperand = co_await ctx->Parse(ParseUnaryExpression, flags);
 	}
-exit:
 
 	if (precedence <= Precedence::Ternary && ctx->PeekToken()->Kind() == SyntaxKind::QuestionSymbol)
 	{
@@ -844,11 +790,40 @@ exit:
 		leftOperand = ctx->CreateSyntax<TernaryExpression>(leftOperand, questionToken, trueExpression, colonToken, falseExpression);
 	}
 
+	// the right operand of the innermost pending operation is complete.
+	if (!operations.empty())
+	{
+		Operation operation = operations.back();
+		operations.pop_back();
+
+		leftOperand = ctx->CreateSyntax<BinaryExpression>(operation.binaryOperator, operation.leftOperand, operation.operatorToken, leftOperand);
+		precedence = operation.precedence;
+
+		goto parseOperator;
+	}
+
 	co_return leftOperand;
 }
 
 } // namespace Rules
 
+#define COROGLL_RULE(X)                  \
+	X( ParseArgument                  ) \
+	X( ParseArgumentList              ) \
+	X( ParseParensExpression          ) \
+	X( ParseCastExpression            ) \
+	X( ParseLambdaExpression          ) \
+	X( ParseMetaExpression            ) \
+	X( ParseCallExpression            ) \
+	X( ParseIndexExpression           ) \
+	X( ParseSpecializationExpression  ) \
+	X( ParseScopeAccessExpression     ) \
+	X( ParseDirectAccessExpression    ) \
+	X( ParseIndirectAccessExpression  ) \
+	X( ParsePrimaryExpression         ) \
+	X( ParseUnaryExpression           ) \
+	X( ParseExpression                ) \
+
 template<typename TSyntax, typename... TParams>
 Result<TSyntax> ParseRoot(Ctx* ctx, Result<TSyntax>(*func)(Ctx*, TParams...), TParams... args)
 {
@@ -864,21 +839,132 @@ Result<TSyntax> ParseRoot(Ctx* ctx, Result<TSyntax>(*func)(Ctx*, TParams...), TP
 }
 
 template<typename TSyntax, typename... TParams, typename... TArgs>
-SyntaxTree ParseInternal(std::string_view text, Result<TSyntax>(*func)(Ctx*, TParams...), TArgs&&... args)
+SyntaxTree ParseInternal(std::string_view text, const ParseOptions& options, Result<TSyntax>(*func)(Ctx*, TParams...), TArgs&&... args)
 {
+	ParseStats* stats = EnableParseStats ? options.stats : nullptr;
+	if (stats != nullptr)
+		*stats = ParseStats();
+
 	Private::SyntaxTreeContext treeContext;
-	std::vector<Token*> tokenVector = Private::Lex(text, &treeContext);
+	std::vector<Token*> tokenVector = Private::Lex(text, &treeContext, stats);
 
 	Span<Token*> tokens(tokenVector.data(), tokenVector.size());
-	TSyntax* syntax = CoroGLL::Private::ParserCore::Parse(tokens, &treeContext,
-		ParseRoot<TSyntax, TParams...>, func, std::forward<TArgs>(args)...);
+	std::vector<i32> bracketVector = Private::MatchBrackets(tokens, stats);
+
+	Span<const i32> brackets(bracketVector.data(), bracketVector.size());
+
+	ParseStatus status;
+	TSyntax* syntax;
+	{
+		Private::StatsTimer timer(stats != nullptr ? &stats->parseNanoseconds : nullptr);
+		syntax = CoroGLL::Private::ParserCore::Parse(tokens, brackets, &treeContext, options, &status,
+			ParseRoot<TSyntax, TParams...>, func, std::forward<TArgs>(args)...);
+	}
 
-	return Private::SyntaxTreeAttorney::CreateSyntaxTree(syntax, std::move(treeContext));
+	return Private::SyntaxTreeAttorney::CreateSyntaxTree(syntax, status, std::move(treeContext));
+}
+
+template<typename TSyntax, typename... TParams, typename... TArgs>
+ParseInfo CreateRootParseInfo(Result<TSyntax>(*func)(Ctx*, TParams...), TArgs&&... args)
+{
+	return ParseInfo(ParseRoot<TSyntax, TParams...>, func, std::forward<TArgs>(args)...);
 }
 
 } // namespace
 
+struct CoroGLL::ParseSession::State
+{
+	State(std::string_view text, const ParseOptions& options, ParseInfo parseInfo)
+		: options(options)
+		, stats(ResetStats(options.stats))
+		, tokenVector(Private::Lex(text, &treeContext, stats))
+		, bracketVector(Private::MatchBrackets(Span<Token*>(tokenVector.data(), tokenVector.size()), stats))
+		, session(Span<Token*>(tokenVector.data(), tokenVector.size()), Span<const i32>(bracketVector.data(), bracketVector.size()),
+			&treeContext, this->options, std::move(parseInfo))
+	{
+	}
+
+	static ParseStats* ResetStats(ParseStats* stats)
+	{
+		if (!EnableParseStats || stats == nullptr)
+			return nullptr;
+
+		*stats = ParseStats();
+		return stats;
+	}
+
+	ParseOptions options;
+	ParseStats* stats;
+
+	//the engine only writes the stats once finished
+	u64 parseNanoseconds = 0;
+
+	Private::SyntaxTreeContext treeContext;
+
+	std::vector<Token*> tokenVector;
+	std::vector<i32> bracketVector;
+
+	Private::ParserCore::Session session;
+	bool finished = false;
+};
+
+std::string_view CoroGLL::GetRuleName(ParseRule rule)
+{
+#define COROGLL_X(n) if (rule == (ParseRule)Rules::n) return #n;
+	COROGLL_RULE(COROGLL_X)
+#undef COROGLL_X
+
+	if (rule == (ParseRule)ParseRoot<Expression, Flags, Precedence>)
+		return "ParseRoot";
+
+	return "Unknown";
+}
+
 SyntaxTree CoroGLL::ParseExpression(std::string_view text)
 {
-	return ParseInternal(text, Rules::ParseExpression, Flags::None, Precedence::Expression);
+	return ParseExpression(text, ParseOptions());
+}
+
+SyntaxTree CoroGLL::ParseExpression(std::string_view text, const ParseOptions& options)
+{
+	return ParseInternal(text, options, Rules::ParseExpression, Flags::None, Precedence::Expression);
+}
+
+CoroGLL::Ast::Syntax* CoroGLL::Private::ParseExpression(Span<Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseStatus* status)
+{
+	return ParserCore::Parse(tokens, brackets, treeContext, options, status,
+		ParseRoot<Expression, Flags, Precedence>, Rules::ParseExpression, Flags::None, Precedence::Expression);
+}
+
+CoroGLL::ParseSession::ParseSession(std::string_view text, const ParseOptions& options)
+	: m_state(new State(text, options, CreateRootParseInfo(Rules::ParseExpression, Flags::None, Precedence::Expression)))
+{
+}
+
+CoroGLL::ParseSession::~ParseSession() = default;
+
+CoroGLL::ParseSession::ParseSession(ParseSession&&) = default;
+CoroGLL::ParseSession& CoroGLL::ParseSession::operator=(ParseSession&&) = default;
+
+ParseProgress CoroGLL::ParseSession::Step(u64 maxSteps)
+{
+	if (!m_state->finished)
+	{
+		ParseStats* stats = m_state->stats;
+		{
+			Private::StatsTimer timer(stats != nullptr ? &m_state->parseNanoseconds : nullptr);
+			m_state->finished = m_state->session.Step(maxSteps);
+		}
+
+		if (m_state->finished && stats != nullptr)
+			stats->parseNanoseconds = m_state->parseNanoseconds;
+	}
+
+	return m_state->finished ? ParseProgress::Done : ParseProgress::InProgress;
+}
+
+SyntaxTree CoroGLL::ParseSession::TakeTree()
+{
+	Assert(m_state->finished);
+	return Private::SyntaxTreeAttorney::CreateSyntaxTree(m_state->session.GetResult(), m_state->session.GetStatus(), std::move(m_state->treeContext));
 }
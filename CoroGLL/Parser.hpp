@@ -1,11 +1,56 @@
 #pragma once
 
+#include "ParseOptions.hpp"
 #include "SyntaxTree.hpp"
+#include "Syntax/Token.hpp"
 
+#include <memory>
 #include <string_view>
 
+namespace CoroGLL::Private {
+
+// Parses an expression from already lexed tokens, allocating the syntax in the tree context.
+// The lex and match fields of the stats are kept as the caller left them, the rest are overwritten.
+Ast::Syntax* ParseExpression(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseStatus* status);
+
+} // namespace CoroGLL::Private
+
 namespace CoroGLL {
 
 SyntaxTree ParseExpression(std::string_view text);
+SyntaxTree ParseExpression(std::string_view text, const ParseOptions& options);
+
+// Name of the grammar function of a rule reported in a ParseEvent.
+std::string_view GetRuleName(ParseRule rule);
+
+enum class ParseProgress
+{
+	InProgress,
+	Done,
+};
+
+// Expression parse which runs in slices, for interleaving many parses on one thread.
+// The text is lexed by the constructor and need not outlive it, as the tokens copy their strings into the tree.
+// The options are copied, but the objects they point to must outlive the session.
+// Destroying an unfinished session cancels the parse, which is reported to the stats and the observer.
+class ParseSession
+{
+public:
+	ParseSession(std::string_view text, const ParseOptions& options);
+	~ParseSession();
+
+	ParseSession(ParseSession&&);
+	ParseSession& operator=(ParseSession&&);
+
+	// Resumes the parse for at most the given number of engine steps.
+	ParseProgress Step(u64 maxSteps);
+
+	// Moves the tree out of a finished session.
+	SyntaxTree TakeTree();
+
+private:
+	struct State;
+	std::unique_ptr<State> m_state;
+};
 
 } // namespace CoroGLL
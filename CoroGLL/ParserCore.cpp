@@ -2,6 +2,7 @@
 
 #include "Core/Storage.hpp"
 
+#include <algorithm>
 #include <exception>
 #include <vector>
 
@@ -26,8 +27,8 @@ struct Frame
 		Ready,
 	};
 
-	Frame(i32 tokenIndex, ParseInfo parseInfo, std::size_t coroSize)
-		: m_tokenIndex(tokenIndex), m_parseInfo(std::move(parseInfo)), m_coroSize(coroSize)
+	Frame(i32 tokenIndex, ParseInfo parseInfo)
+		: m_tokenIndex(tokenIndex), m_parseInfo(std::move(parseInfo))
 	{
 	}
 
@@ -51,9 +52,27 @@ struct Frame
 		m_forks.erase(GetForkIterator(fork));
 	}
 
+	void RemoveDependant(FrameFork* fork)
+	{
+		for (auto first = m_dependants.begin(), last = m_dependants.end();; ++first)
+		{
+			Assert(first != last);
+			if (*first == fork)
+			{
+				m_dependants.erase(first);
+				break;
+			}
+		}
+	}
+
 	i32 m_tokenIndex;
 	ParseInfo m_parseInfo;
-	std::size_t m_coroSize;
+
+	//numbers frames for the observer
+	u32 m_id = 0;
+
+	//position in the list of frames owned by the parser
+	std::size_t m_ownerIndex = 0;
 
 	State m_state = State::None;
 
@@ -80,21 +99,24 @@ struct FrameFork
 		Parse,
 		Error,
 		Ready,
+
+		//an untried alternative of an ordered choice
+		Deferred,
 	};
 
 	FrameFork(FrameFork* fork)
-		: m_frame(fork->m_frame), m_tokenIndex(fork->m_tokenIndex), m_state(State::Queue)
+		: m_frame(fork->m_frame), m_tokenIndex(fork->m_tokenIndex), m_state(State::Queue), m_coroSize(fork->m_coroSize), m_started(fork->m_started)
 	{
 		// copy the coroutine frame. sue me.
-		m_coroBuffer = std::malloc(m_frame->m_coroSize);
-		std::memcpy(m_coroBuffer, fork->m_coroBuffer, m_frame->m_coroSize);
+		m_coroBuffer = std::malloc(m_coroSize);
+		std::memcpy(m_coroBuffer, fork->m_coroBuffer, m_coroSize);
 
 		std::ptrdiff_t offset = (char*)fork->m_coro.address() - (char*)fork->m_coroBuffer;
 		m_coro = stdx::coroutine_handle<>::from_address((char*)m_coroBuffer + offset);
 	}
 
-	FrameFork(Frame* frame, void* coroBuffer, stdx::coroutine_handle<> coro)
-		: m_frame(frame), m_tokenIndex(frame->m_tokenIndex), m_state(State::Queue), m_coroBuffer(coroBuffer), m_coro(coro)
+	FrameFork(Frame* frame, std::size_t coroSize, void* coroBuffer, stdx::coroutine_handle<> coro)
+		: m_frame(frame), m_tokenIndex(frame->m_tokenIndex), m_state(State::Queue), m_coroSize(coroSize), m_coroBuffer(coroBuffer), m_coro(coro)
 	{
 	}
 
@@ -106,9 +128,17 @@ struct FrameFork
 	Frame* m_frame;
 	i32 m_tokenIndex;
 
+	//numbers forks for the observer
+	u32 m_id = 0;
+
+	//the coroutine changes on tail parse, along with its size
+	std::size_t m_coroSize;
 	void* m_coroBuffer;
 	stdx::coroutine_handle<> m_coro;
 
+	//the coroutine has been resumed past its initial suspension
+	bool m_started = false;
+
 	State m_state;
 
 	union {
@@ -118,6 +148,9 @@ struct FrameFork
 	} m_value;
 
 	FrameFork* m_errorFork;
+
+	//set while the fork is waiting at a join point
+	JoinInfo m_join;
 };
 
 class ParseContextImpl : ParseContext
@@ -133,16 +166,21 @@ class ParseContextImpl : ParseContext
 		Suspend_Fork,
 		Suspend_Parse,
 		Suspend_Error,
+		Suspend_Commit,
+		Suspend_Join,
 
 		Exit_Ready,
+		Exit_Tail,
 		Exit_Throw,
 	};
 
 public:
-	ParseContextImpl(Span<Ast::Token* const> tokens, SyntaxTreeContext* treeContext)
+	ParseContextImpl(Span<Ast::Token* const> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options)
 	{
 		m_tokens = tokens;
+		m_brackets = brackets;
 		m_treeContext = treeContext;
+		m_options = &options;
 
 		m_tokenIndex = 0;
 	}
@@ -160,20 +198,38 @@ public:
 		Assert(std::exchange(m_state, State::Enter) == State::None);
 		Promise* promise = parseInfo.Execute(this);
 
-		new (frame) Frame(tokenIndex, std::move(parseInfo), m_value.coro.size);
-		FrameFork* fork = new FrameFork(frame, m_value.coro.buffer, promise->GetCoro());
+		new (frame) Frame(tokenIndex, std::move(parseInfo));
+		FrameFork* fork = new FrameFork(frame, m_value.coro.size, m_value.coro.buffer, promise->GetCoro());
 		frame->m_forks.push_back(fork);
 
 		promise->SetContext(this);
 	}
 
+	//replaces the exited coroutine of the fork with a new one
+	void CreateTail(FrameFork* fork, ParseInfo parseInfo)
+	{
+		Assert(std::exchange(m_state, State::Enter) == State::None);
+		Promise* promise = parseInfo.Execute(this);
+
+		std::free(fork->m_coroBuffer);
+		fork->m_coroSize = m_value.coro.size;
+		fork->m_coroBuffer = m_value.coro.buffer;
+		fork->m_coro = promise->GetCoro();
+		fork->m_started = false;
+
+		promise->SetContext(this);
+	}
+
 
 	enum class ResumeResult
 	{
 		Fork  = (i32)State::Suspend_Fork,
 		Parse = (i32)State::Suspend_Parse,
-		Error = (i32)State::Suspend_Error,
-		Ready = (i32)State::Exit_Ready,
+		Error  = (i32)State::Suspend_Error,
+		Commit = (i32)State::Suspend_Commit,
+		Join   = (i32)State::Suspend_Join,
+		Ready  = (i32)State::Exit_Ready,
+		Tail   = (i32)State::Exit_Tail,
 	};
 
 	ResumeResult Resume(FrameFork* fork)
@@ -182,8 +238,10 @@ public:
 		Assert(std::exchange(m_state, State::Resume) == State::None);
 
 		m_tokenIndex = fork->m_tokenIndex;
+		fork->m_join = JoinInfo();
 
 		m_value.fork = fork;
+		fork->m_started = true;
 		fork->m_coro.resume();
 
 		fork->m_tokenIndex = m_tokenIndex;
@@ -194,9 +252,12 @@ public:
 		switch (state)
 		{
 		case State::Exit_Ready:
+		case State::Exit_Tail:
 		case State::Suspend_Fork:
 		case State::Suspend_Parse:
 		case State::Suspend_Error:
+		case State::Suspend_Commit:
+		case State::Suspend_Join:
 			break;
 
 		default:
@@ -207,10 +268,16 @@ public:
 		return (ResumeResult)state;
 	}
 
-	i32 TakeForkCount()
+	struct ForkInfo
+	{
+		i32 count;
+		u32 mask;
+	};
+
+	ForkInfo TakeForkInfo()
 	{
 		Assert(std::exchange(m_state, State::None) == State::Suspend_Fork);
-		return m_value.forkCount;
+		return m_value.forkInfo;
 	}
 
 	ParseInfo TakeParseInfo()
@@ -229,15 +296,43 @@ public:
 		return errorInfo;
 	}
 
+	void TakeCommit()
+	{
+		Assert(std::exchange(m_state, State::None) == State::Suspend_Commit);
+	}
+
+	JoinInfo TakeJoinInfo()
+	{
+		Assert(std::exchange(m_state, State::None) == State::Suspend_Join);
+		JoinInfo joinInfo(std::move(*m_value.joinInfo));
+		m_value.joinInfo.Destroy();
+		return joinInfo;
+	}
+
 	Ast::Syntax* TakeSyntax()
 	{
 		Assert(std::exchange(m_state, State::None) == State::Exit_Ready);
 		return m_value.syntax;
 	}
 
+	ParseInfo TakeTailInfo()
+	{
+		Assert(std::exchange(m_state, State::None) == State::Exit_Tail);
+		ParseInfo parseInfo(std::move(*m_value.parseInfo));
+		m_value.parseInfo.Destroy();
+		return parseInfo;
+	}
+
 
 	void TerminateFork(FrameFork* fork)
 	{
+		//there is nothing to unwind before the first resume
+		if (!fork->m_started)
+		{
+			fork->m_coro.destroy();
+			return;
+		}
+
 		m_state = State::Terminate;
 		fork->m_coro.resume();
 
@@ -274,9 +369,10 @@ private:
 		Frame* frame;
 		FrameFork* fork;
 
-		i32 forkCount;
+		ForkInfo forkInfo;
 		Storage<ParseInfo> parseInfo;
 		Storage<ErrorInfo> errorInfo;
+		Storage<JoinInfo> joinInfo;
 
 		Ast::Syntax* syntax;
 	} m_value;
@@ -289,63 +385,153 @@ typedef ParseContextImpl::ResumeResult ResumeResult;
 class Parser
 {
 public:
-	Parser(Span<Ast::Token*> tokens, SyntaxTreeContext* treeContext)
-		: m_ctx(tokens, treeContext)
+	Parser(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options)
+		: m_ctx(tokens, brackets, treeContext, options), m_options(&options), m_observer(options.observer), m_treeContext(treeContext)
 	{
+		//zero limits are lifted, leaving a single comparison per limit and step
+		auto limit = [](u64 value) { return value != 0 ? value : ~(u64)0; };
+
+		m_maxSteps = limit(options.budget.maxSteps);
+		m_maxLiveFrames = limit(options.budget.maxLiveFrames);
+		m_maxCoroutineBytes = limit(options.budget.maxCoroutineBytes);
+		m_maxArenaBytes = limit(options.budget.maxArenaBytes);
+
+		//the caller may already have recorded the phases preceding the parse,
+		//the counters of the parse itself start from zero
+		if constexpr (EnableParseStats)
+		{
+			if (const ParseStats* stats = options.stats)
+			{
+				m_stats.tokens = stats->tokens;
+				m_stats.lexNanoseconds = stats->lexNanoseconds;
+				m_stats.matchNanoseconds = stats->matchNanoseconds;
+			}
+		}
 	}
 
-	Ast::Syntax* Parse(ParseInfo parseInfo)
+	~Parser()
 	{
-		Storage<Frame> root;
-		m_ctx.CreateFrame(&root, 0, std::move(parseInfo));
+		if (m_root == nullptr)
+			return;
 
-		m_root = &root;
+		//an unfinished parse is cancelled, which is still reported to the stats and the observer
+		if (!m_finished)
+			Abort(ParseStatus::Cancelled);
 
-		Ast::Syntax* syntax = ParseCore();
-		m_frames.clear();
-		return syntax;
+		//frames are memoized for the duration of the parse, their remaining forks are suspended
+		for (Frame* frame : m_ownedFrames)
+		{
+			DestroyFrame(frame);
+			operator delete(frame);
+		}
+		DestroyFrame(m_root);
+	}
+
+	void Start(ParseInfo parseInfo)
+	{
+		m_ctx.CreateFrame(&m_rootStorage, 0, std::move(parseInfo));
+		OnCreateFrame(&m_rootStorage);
+
+		m_root = &m_rootStorage;
+	}
+
+	//runs at most the given number of steps, returns true once the parse is finished
+	bool Step(u64 maxSteps)
+	{
+		Assert(!m_finished);
+		return ParseCore(maxSteps);
+	}
+
+	Ast::Syntax* GetResult() const
+	{
+		Assert(m_finished);
+		return m_result;
+	}
+
+	ParseStatus GetStatus() const
+	{
+		return m_status;
 	}
 
 private:
-	Ast::Syntax* ParseCore()
+	bool ParseCore(u64 maxSteps)
 	{
-		while (true)
+		for (; maxSteps != 0; --maxSteps)
 		{
-			FrameFork* fork = FindLeastAdvancedLeaf();
+			if (const CancellationToken* cancellation = m_options->cancellation; cancellation && cancellation->IsCancelled())
+				return Abort(ParseStatus::Cancelled);
+
+			if (ParseStatus status = CheckBudget(); status != ParseStatus::Complete)
+				return Abort(status);
 
-			if (m_frames.size() > 0)
+			FrameFork* fork = FindNextFork();
+
+			//frames before the least advanced fork can no longer be reached,
+			//unless backtracking or scheduling out of order
+			if (m_options->engineMode == EngineMode::Generalized &&
+				m_options->schedulingPolicy == SchedulingPolicy::LeastAdvanced && m_frames.size() > 0)
 			{
 				i32 tokenIndex = fork->m_tokenIndex;
 
 				auto first = m_frames.begin();
 				decltype(first) it = first;
 
-				for (decltype(first) last = m_frames.begin();
+				for (decltype(first) last = m_frames.end();
 					it != last && (*it)->m_tokenIndex < tokenIndex; ++it);
 
 				m_frames.erase(first, it);
 			}
 
+			m_roundTokenIndex = fork->m_tokenIndex;
+			++m_steps;
+
 			HandleResult handleResult = HandleResult::None;
 
-			switch (m_ctx.Resume(fork))
+			Notify(ParseEventKind::Resume, fork);
+			ResumeResult resumeResult = m_ctx.Resume(fork);
+			Notify(GetSuspendEvent(resumeResult), fork);
+
+			switch (resumeResult)
 			{
 			case ResumeResult::Fork:
 				{
-					i32 forkCount = m_ctx.TakeForkCount();
+					auto [forkCount, forkMask] = m_ctx.TakeForkInfo();
 
 					Frame* frame = fork->m_frame;
 					i32 slotIndex = frame->FindFork(fork) + 1;
 
-					frame->m_forks.reserve(frame->m_forks.size() + forkCount - 1);
-					for (i32 forkIndex = 1; forkIndex < forkCount; ++forkIndex)
+					//the first viable alternative continues in the existing fork
+					i32 forkIndex = 0;
+					while ((forkMask & (u32)1 << forkIndex) == 0)
+						++forkIndex;
+					fork->m_value.forkIndex = forkIndex;
+
+					while (++forkIndex < forkCount)
 					{
+						if ((forkMask & (u32)1 << forkIndex) == 0)
+							continue;
+
+						if (IsForkLimitReached())
+						{
+							m_status = ParseStatus::Truncated;
+							break;
+						}
+
 						FrameFork* newFork = new FrameFork(fork);
 						newFork->m_value.forkIndex = forkIndex;
+						OnCreateFork(newFork);
+
+						if constexpr (EnableParseStats)
+							m_stats.forkBytesCopied += newFork->m_coroSize;
+
+						if (m_options->engineMode == EngineMode::OrderedChoice)
+							newFork->m_state = FrameFork::State::Deferred;
 
 						frame->m_forks.insert(frame->m_forks.begin() + slotIndex++, newFork);
 					}
-					fork->m_value.forkIndex = 0;
+
+					if (m_options->maxForksPerFrame != 0)
+						TruncateFrame(frame, fork, m_options->maxForksPerFrame);
 				}
 				break;
 
@@ -353,6 +539,14 @@ private:
 				{
 					Frame* dependency = FindOrCreateFrame(fork->m_tokenIndex, m_ctx.TakeParseInfo());
 
+					//the initial fork of a new frame would exceed the limit, so the fork fails in its place
+					if (dependency == nullptr)
+					{
+						m_status = ParseStatus::Truncated;
+						handleResult = HandleError(fork, fork);
+						break;
+					}
+
 					switch (dependency->m_state)
 					{
 					case Frame::State::None:
@@ -378,30 +572,115 @@ private:
 				handleResult = HandleError(fork, fork);
 				break;
 
+			case ResumeResult::Commit:
+				m_ctx.TakeCommit();
+				HandleCommit(fork);
+				break;
+
+			case ResumeResult::Join:
+				HandleJoin(fork, m_ctx.TakeJoinInfo());
+				break;
+
 			case ResumeResult::Ready:
 				handleResult = HandleReady(fork, m_ctx.TakeSyntax());
 				break;
+
+			case ResumeResult::Tail:
+				//the fork now runs the callee in place of the exited caller
+				m_liveCoroutineBytes -= fork->m_coroSize;
+				m_ctx.CreateTail(fork, m_ctx.TakeTailInfo());
+				m_liveCoroutineBytes += fork->m_coroSize;
+				UpdatePeaks();
+				break;
 			}
 
 			switch (handleResult)
 			{
 			case HandleResult::Error:
+				//the input may well be valid, but the alternatives accepting it were dropped
+				if (m_status == ParseStatus::Truncated)
+					return Abort(ParseStatus::Truncated);
+
 				//TODO: commit temporary syntax
-				SwallowErrors(m_root);
-				break;
+				return Abort(ParseStatus::Error);
 
 			case HandleResult::Ready:
-				return m_root->m_value.syntax;
+				return Finish(m_root->m_value.syntax);
+			}
+		}
+
+		return false;
+	}
+
+	bool Finish(Ast::Syntax* syntax)
+	{
+		m_finished = true;
+		m_result = syntax;
+		m_frames.clear();
+
+		if constexpr (EnableParseStats)
+		{
+			if (ParseStats* stats = m_options->stats)
+			{
+				m_stats.steps = m_steps;
+				m_stats.treeBytes = m_treeContext->AllocatedBytes();
+				m_stats.treeAllocations = m_treeContext->AllocationCount();
+				*stats = m_stats;
 			}
 		}
+
+		return true;
 	}
 
-	FrameFork* FindLeastAdvancedLeaf()
+	ParseStatus CheckBudget() const
 	{
-		return FindLeastAdvancedLeaf(m_root);
+		if (m_steps >= m_maxSteps)
+			return ParseStatus::StepBudgetExceeded;
+
+		if (m_liveFrames > m_maxLiveFrames)
+			return ParseStatus::FrameBudgetExceeded;
+
+		if (m_liveCoroutineBytes > m_maxCoroutineBytes)
+			return ParseStatus::CoroutineBudgetExceeded;
+
+		if (m_treeContext->AllocatedBytes() > m_maxArenaBytes)
+			return ParseStatus::ArenaBudgetExceeded;
+
+		return ParseStatus::Complete;
+	}
+
+	//abandons the parse, terminating all pending forks
+	bool Abort(ParseStatus status)
+	{
+		for (FrameFork* fork : m_root->m_forks)
+			DiscardFork(fork);
+		m_root->m_forks.clear();
+
+		m_status = status;
+		return Finish(nullptr);
 	}
 
-	FrameFork* FindLeastAdvancedLeaf(Frame* frame)
+	FrameFork* FindNextFork()
+	{
+		switch (m_options->schedulingPolicy)
+		{
+		case SchedulingPolicy::LeastAdvanced:
+			return FindLeaf(m_root, [](FrameFork* a, FrameFork* b) { return IsLessAdvanced(a, b); });
+
+		case SchedulingPolicy::DepthFirst:
+			return FindLeaf(m_root, [](FrameFork* a, FrameFork* b) { return IsLessParked(a, b); });
+
+		case SchedulingPolicy::RoundRobin:
+			return FindLeaf(m_root, [this](FrameFork* a, FrameFork* b) { return IsNextInRound(a, b); });
+		}
+
+		Assert(false);
+		return nullptr;
+	}
+
+	//finds the best leaf fork by the given ordering, or the most preferred one among equals
+	template<typename TIsBetter>
+	FrameFork* FindLeaf(Frame* frame, const TIsBetter& isBetter)
 	{
 		FrameFork* candidate = nullptr;
 
@@ -410,10 +689,14 @@ private:
 			switch (fork->m_state)
 			{
 			case FrameFork::State::Parse:
-				fork = FindLeastAdvancedLeaf(fork->m_value.dependency);
+				//the fork has already failed along with its dependency
+				if (fork->m_value.dependency->m_state != Frame::State::None)
+					break;
+
+				fork = FindLeaf(fork->m_value.dependency, isBetter);
 
 			case FrameFork::State::Queue:
-				if (!candidate || fork->m_tokenIndex < candidate->m_tokenIndex)
+				if (!candidate || isBetter(fork, candidate))
 					candidate = fork;
 			}
 		}
@@ -422,22 +705,65 @@ private:
 		return candidate;
 	}
 
+	static bool IsLessAdvanced(FrameFork* a, FrameFork* b)
+	{
+		if (a->m_tokenIndex != b->m_tokenIndex)
+			return a->m_tokenIndex < b->m_tokenIndex;
+
+		return IsLessParked(a, b);
+	}
+
+	//forks waiting at a join point yield to give their siblings a chance to join them
+	static bool IsLessParked(FrameFork* a, FrameFork* b)
+	{
+		return !a->m_join && b->m_join;
+	}
+
+	//forks past the position of the previous step come first, then the rest from the start
+	bool IsNextInRound(FrameFork* a, FrameFork* b) const
+	{
+		bool aWrapped = a->m_tokenIndex <= m_roundTokenIndex;
+		bool bWrapped = b->m_tokenIndex <= m_roundTokenIndex;
+
+		if (aWrapped != bWrapped)
+			return bWrapped;
+
+		return IsLessAdvanced(a, b);
+	}
+
+	//returns null if creating the frame would exceed the live fork limit
 	Frame* FindOrCreateFrame(i32 tokenIndex, ParseInfo parseInfo)
 	{
-		auto iterator = m_frames.begin();
+		//frames are ordered by their starting token index
+		auto iterator = std::lower_bound(m_frames.begin(), m_frames.end(), tokenIndex,
+			[](Frame* frame, i32 tokenIndex) { return frame->m_tokenIndex < tokenIndex; });
+
 		for (decltype(iterator) end = m_frames.end(); iterator != end; ++iterator)
 		{
 			Frame* frame = *iterator;
 
 			if (frame->m_tokenIndex == tokenIndex && frame->m_parseInfo == parseInfo)
+			{
+				if constexpr (EnableParseStats)
+					++m_stats.memoHits;
+				Notify(ParseEventKind::MemoHit, frame);
 				return frame;
+			}
 
 			if (frame->m_tokenIndex > tokenIndex)
 				break;
 		}
 
+		if (IsForkLimitReached())
+			return nullptr;
+
 		Frame* frame = m_ctx.CreateFrame(tokenIndex, std::move(parseInfo));
+		OnCreateFrame(frame);
 		m_frames.insert(iterator, frame);
+
+		frame->m_ownerIndex = m_ownedFrames.size();
+		m_ownedFrames.push_back(frame);
+
 		return frame;
 	}
 
@@ -456,14 +782,17 @@ private:
 
 		Frame* frame = fork->m_frame;
 
+		if (m_options->engineMode == EngineMode::OrderedChoice)
+			ResumeDeferredFork(frame);
+
 		if (frame->m_forks.size() == 1)
 			return HandleError(frame, errorFork);
 
 		if (FrameFork* ready = frame->m_ready)
 		{
 			frame->RemoveFork(fork);
-			m_ctx.TerminateFork(fork);
-			delete fork;
+			TerminateFork(fork);
+			DeleteFork(fork);
 
 			if (frame->m_forks.size() == 1)
 				return HandleReady(frame, ready->m_value.syntax);
@@ -481,8 +810,8 @@ private:
 			}
 
 			frame->RemoveFork(fork);
-			m_ctx.TerminateFork(fork);
-			delete fork;
+			TerminateFork(fork);
+			DeleteFork(fork);
 
 			if (frame->m_forks.size() == 1)
 				return HandleError(frame, error->m_errorFork);
@@ -510,13 +839,13 @@ private:
 			//the newly ready fork must be better
 
 			frame->RemoveFork(ready);
-			delete ready;
+			DeleteFork(ready);
 		}
 		else if (FrameFork* error = frame->m_error)
 		{
 			frame->RemoveFork(error);
-			m_ctx.TerminateFork(error);
-			delete error;
+			TerminateFork(error);
+			DeleteFork(error);
 
 			frame->m_error = nullptr;
 		}
@@ -534,8 +863,8 @@ private:
 				do
 				{
 					FrameFork* x = *it++;
-					m_ctx.TerminateFork(x);
-					delete x;
+					TerminateFork(x);
+					DeleteFork(x);
 				} while (it != last);
 
 				frame->m_forks.erase(first, last);
@@ -552,6 +881,7 @@ private:
 	{
 		frame->m_state = Frame::State::Error;
 		frame->m_value.errorFork = errorFork;
+		Notify(ParseEventKind::FailFrame, frame);
 
 		if (frame == m_root)
 			return HandleResult::Error;
@@ -572,12 +902,18 @@ private:
 		i32 tokenIndex = fork->m_tokenIndex;
 
 		frame->m_state = Frame::State::Ready;
-		frame->m_tokenIndex = tokenIndex;
 		frame->m_value.syntax = syntax;
+		frame->m_value.tokenIndex = tokenIndex;
+		Notify(ParseEventKind::ReadyFrame, frame);
 
 		if (frame == m_root)
 			return HandleResult::Ready;
 
+		//the frame is memoized by its result alone, the exited fork can go
+		DeleteFork(fork);
+		frame->m_forks.clear();
+		frame->m_ready = nullptr;
+
 		//TODO: temporarily take shared ownership of the frame
 
 		for (FrameFork* dependant : frame->m_dependants)
@@ -591,26 +927,231 @@ private:
 		return HandleResult::None;
 	}
 
-	void SwallowErrors(Frame* frame)
+	//queues the next untried alternative of an ordered choice, if any
+	void ResumeDeferredFork(Frame* frame)
 	{
-		Assert(frame->m_state == Frame::State::Error);
-		frame->m_state = Frame::State::None;
+		for (FrameFork* fork : frame->m_forks)
+		{
+			if (fork->m_state == FrameFork::State::Deferred)
+			{
+				fork->m_state = FrameFork::State::Queue;
+				break;
+			}
+		}
+	}
 
-		Assert(frame->m_forks.size() == 1);
-		FrameFork* fork = frame->m_forks[0];
+	void HandleCommit(FrameFork* fork)
+	{
+		Frame* frame = fork->m_frame;
+
+		for (FrameFork* other : frame->m_forks)
+		{
+			if (other != fork)
+				DiscardFork(other);
+		}
+
+		frame->m_forks.assign(1, fork);
+		frame->m_error = nullptr;
+		frame->m_ready = nullptr;
+	}
+
+	void HandleJoin(FrameFork* fork, JoinInfo joinInfo)
+	{
+		Frame* frame = fork->m_frame;
+
+		for (FrameFork* other : frame->m_forks)
+		{
+			if (other == fork || other->m_tokenIndex != fork->m_tokenIndex || other->m_join != joinInfo)
+				continue;
+
+			if (IsBetter(other, fork))
+			{
+				frame->RemoveFork(fork);
+				DiscardFork(fork);
+				return;
+			}
 
+			frame->RemoveFork(other);
+			DiscardFork(other);
+			break;
+		}
+
+		fork->m_join = std::move(joinInfo);
+	}
+
+	bool IsForkLimitReached() const
+	{
+		return m_options->maxLiveForks != 0 && m_liveForks >= (u64)m_options->maxLiveForks;
+	}
+
+	//drops the least preferred forks after the given fork until the frame is within the limit
+	void TruncateFrame(Frame* frame, FrameFork* fork, i32 maxForks)
+	{
+		i32 minForks = frame->FindFork(fork) + 1;
+
+		while ((i32)frame->m_forks.size() > std::max(maxForks, minForks))
+		{
+			FrameFork* last = frame->m_forks.back();
+			frame->m_forks.pop_back();
+
+			if (last == frame->m_ready)
+				frame->m_ready = nullptr;
+
+			if (last == frame->m_error)
+				frame->m_error = nullptr;
+
+			DiscardFork(last);
+			m_status = ParseStatus::Truncated;
+		}
+	}
+
+	//terminates a fork which is no longer part of its frame
+	void DiscardFork(FrameFork* fork)
+	{
 		switch (fork->m_state)
 		{
 		case FrameFork::State::Parse:
-			SwallowErrors(fork->m_value.dependency);
+			{
+				Frame* dependency = fork->m_value.dependency;
+				dependency->RemoveDependant(fork);
+
+				if (dependency->m_dependants.empty() && dependency->m_state == Frame::State::None)
+					DiscardFrame(dependency);
+			}
+			TerminateFork(fork);
 			break;
 
+		case FrameFork::State::Queue:
 		case FrameFork::State::Error:
-			fork->m_state = FrameFork::State::Queue;
+		case FrameFork::State::Deferred:
+			TerminateFork(fork);
 			break;
 
-		default:
-			Assert(false);
+		case FrameFork::State::Ready:
+			//the coroutine has already exited
+			break;
+		}
+
+		DeleteFork(fork);
+	}
+
+	//terminates a pending frame which nothing depends on anymore
+	void DiscardFrame(Frame* frame)
+	{
+		Assert(frame != m_root && frame->m_state == Frame::State::None);
+		Notify(ParseEventKind::DiscardFrame, frame);
+
+		for (FrameFork* fork : frame->m_forks)
+			DiscardFork(fork);
+
+		for (auto first = m_frames.begin(), last = m_frames.end(); first != last; ++first)
+		{
+			if (*first == frame)
+			{
+				m_frames.erase(first);
+				break;
+			}
+		}
+
+		{
+			Frame* last = m_ownedFrames.back();
+			last->m_ownerIndex = frame->m_ownerIndex;
+			m_ownedFrames[frame->m_ownerIndex] = last;
+			m_ownedFrames.pop_back();
+		}
+
+		frame->~Frame();
+		operator delete(frame);
+		--m_liveFrames;
+	}
+
+	//releases a frame once the parse is over, without reporting its forks
+	void DestroyFrame(Frame* frame)
+	{
+		for (FrameFork* fork : frame->m_forks)
+		{
+			if (fork->m_state != FrameFork::State::Ready)
+				m_ctx.TerminateFork(fork);
+			DeleteFork(fork);
+		}
+
+		frame->~Frame();
+	}
+
+	void OnCreateFrame(Frame* frame)
+	{
+		if constexpr (EnableParseStats)
+			++m_stats.frames;
+		++m_liveFrames;
+
+		frame->m_id = ++m_frameCount;
+		Notify(ParseEventKind::CreateFrame, frame);
+
+		OnCreateFork(frame->m_forks[0]);
+	}
+
+	void OnCreateFork(FrameFork* fork)
+	{
+		if constexpr (EnableParseStats)
+			++m_stats.forks;
+		++m_liveForks;
+		m_liveCoroutineBytes += fork->m_coroSize;
+		UpdatePeaks();
+
+		fork->m_id = ++m_forkCount;
+		Notify(ParseEventKind::CreateFork, fork);
+	}
+
+	void TerminateFork(FrameFork* fork)
+	{
+		if constexpr (EnableParseStats)
+			++m_stats.forksTerminated;
+		Notify(ParseEventKind::TerminateFork, fork);
+		m_ctx.TerminateFork(fork);
+	}
+
+	void Notify(ParseEventKind kind, FrameFork* fork)
+	{
+		if (m_observer != nullptr)
+			m_observer->OnEvent({ kind, fork->m_tokenIndex, fork->m_frame->m_id, fork->m_id, fork->m_frame->m_parseInfo.GetRule(), (u32)fork->m_coroSize });
+	}
+
+	void Notify(ParseEventKind kind, Frame* frame)
+	{
+		if (m_observer != nullptr)
+			m_observer->OnEvent({ kind, frame->m_tokenIndex, frame->m_id, 0, frame->m_parseInfo.GetRule(), 0 });
+	}
+
+	static ParseEventKind GetSuspendEvent(ResumeResult resumeResult)
+	{
+		switch (resumeResult)
+		{
+		case ResumeResult::Fork: return ParseEventKind::Suspend_Fork;
+		case ResumeResult::Parse: return ParseEventKind::Suspend_Parse;
+		case ResumeResult::Error: return ParseEventKind::Suspend_Error;
+		case ResumeResult::Commit: return ParseEventKind::Suspend_Commit;
+		case ResumeResult::Join: return ParseEventKind::Suspend_Join;
+		case ResumeResult::Ready: return ParseEventKind::Exit_Ready;
+		case ResumeResult::Tail: return ParseEventKind::Exit_Tail;
+		}
+
+		Assert(false);
+		return ParseEventKind::Resume;
+	}
+
+	void DeleteFork(FrameFork* fork)
+	{
+		--m_liveForks;
+		m_liveCoroutineBytes -= fork->m_coroSize;
+		delete fork;
+	}
+
+	void UpdatePeaks()
+	{
+		if constexpr (EnableParseStats)
+		{
+			m_stats.peakLiveForks = std::max(m_stats.peakLiveForks, m_liveForks);
+			m_stats.peakCoroutineBytes = std::max(m_stats.peakCoroutineBytes, m_liveCoroutineBytes);
 		}
 	}
 
@@ -623,9 +1164,37 @@ private:
 	}
 
 	ParseContextImpl m_ctx;
+	const ParseOptions* m_options;
+	ParseObserver* m_observer;
+	SyntaxTreeContext* m_treeContext;
 
 	std::vector<Frame*> m_frames;
-	Frame* m_root;
+	Storage<Frame> m_rootStorage;
+	Frame* m_root = nullptr;
+
+	//every frame but the root, including those no longer memoized
+	std::vector<Frame*> m_ownedFrames;
+
+	bool m_finished = false;
+	Ast::Syntax* m_result = nullptr;
+
+	//position of the previous step, for round robin scheduling
+	i32 m_roundTokenIndex = 0;
+
+	ParseStatus m_status = ParseStatus::Complete;
+
+	ParseStats m_stats;
+	u64 m_steps = 0;
+	u32 m_frameCount = 0;
+	u32 m_forkCount = 0;
+	u64 m_liveFrames = 0;
+	u64 m_liveForks = 0;
+	u64 m_liveCoroutineBytes = 0;
+
+	u64 m_maxSteps;
+	u64 m_maxLiveFrames;
+	u64 m_maxCoroutineBytes;
+	u64 m_maxArenaBytes;
 };
 
 } // namespace
@@ -644,10 +1213,10 @@ void* ParseContextCore::Enter(std::size_t coroSize)
 	return buffer;
 }
 
-void ParseContextCore::Suspend_Fork(i32 forkCount)
+void ParseContextCore::Suspend_Fork(i32 forkCount, u32 forkMask)
 {
 	this->OnSuspend(ParseContextImpl::State::Suspend_Fork);
-	this->m_value.forkCount = forkCount;
+	this->m_value.forkInfo = { forkCount, forkMask };
 }
 
 i32 ParseContextCore::Resume_Fork()
@@ -679,12 +1248,39 @@ void ParseContextCore::Resume_Error()
 	this->OnResume();
 }
 
+void ParseContextCore::Suspend_Commit()
+{
+	this->OnSuspend(ParseContextImpl::State::Suspend_Commit);
+}
+
+void ParseContextCore::Resume_Commit()
+{
+	this->OnResume();
+}
+
+void ParseContextCore::Suspend_Join(JoinInfo joinInfo)
+{
+	this->OnSuspend(ParseContextImpl::State::Suspend_Join);
+	this->m_value.joinInfo.Construct(std::move(joinInfo));
+}
+
+void ParseContextCore::Resume_Join()
+{
+	this->OnResume();
+}
+
 void ParseContextCore::Exit_Ready(Ast::Syntax* syntax)
 {
 	this->OnSuspend(ParseContextImpl::State::Exit_Ready);
 	this->m_value.syntax = syntax;
 }
 
+void ParseContextCore::Exit_Tail(ParseInfo parseInfo)
+{
+	this->OnSuspend(ParseContextImpl::State::Exit_Tail);
+	this->m_value.parseInfo.Construct(std::move(parseInfo));
+}
+
 void ParseContextCore::Exit_Throw()
 {
 	typedef ParseContextImpl::State State;
@@ -703,7 +1299,45 @@ void ParseContextCore::Exit_Throw()
 
 #undef this
 
-Ast::Syntax* CoroGLL::Private::ParserCore::ParseCore(Span<Ast::Token*> tokens, SyntaxTreeContext* treeContext, ParseInfo parseInfo)
+class CoroGLL::Private::ParserCore::Session::Engine : public Parser
 {
-	return Parser(tokens, treeContext).Parse(std::move(parseInfo));
+public:
+	using Parser::Parser;
+};
+
+CoroGLL::Private::ParserCore::Session::Session(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseInfo parseInfo)
+	: m_engine(new Engine(tokens, brackets, treeContext, options))
+{
+	m_engine->Start(std::move(parseInfo));
+}
+
+CoroGLL::Private::ParserCore::Session::~Session() = default;
+
+CoroGLL::Private::ParserCore::Session::Session(Session&&) = default;
+CoroGLL::Private::ParserCore::Session& CoroGLL::Private::ParserCore::Session::operator=(Session&&) = default;
+
+bool CoroGLL::Private::ParserCore::Session::Step(u64 maxSteps)
+{
+	return m_engine->Step(maxSteps);
+}
+
+Ast::Syntax* CoroGLL::Private::ParserCore::Session::GetResult() const
+{
+	return m_engine->GetResult();
+}
+
+ParseStatus CoroGLL::Private::ParserCore::Session::GetStatus() const
+{
+	return m_engine->GetStatus();
+}
+
+Ast::Syntax* CoroGLL::Private::ParserCore::ParseCore(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseStatus* status, ParseInfo parseInfo)
+{
+	Parser parser(tokens, brackets, treeContext, options);
+	parser.Start(std::move(parseInfo));
+
+	while (!parser.Step(~(u64)0));
+
+	*status = parser.GetStatus();
+	return parser.GetResult();
 }
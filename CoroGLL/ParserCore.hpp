@@ -3,11 +3,15 @@
 #include "Core/Debug.hpp"
 #include "Core/Span.hpp"
 #include "Core/Types.hpp"
+#include "ParseOptions.hpp"
 #include "Syntax/Syntax.hpp"
 #include "Syntax/Token.hpp"
 #include "SyntaxTree.hpp"
 
+#include <memory>
 #include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
 
 #include <experimental/coroutine>
@@ -85,6 +89,11 @@ class ParseInfo
 			return m_func == other.m_func && DoEquals(other);
 		}
 
+		ParseRule GetRule() const
+		{
+			return m_func;
+		}
+
 		virtual Promise* Execute(ParseContext* context) = 0;
 
 	protected:
@@ -145,6 +154,11 @@ public:
 		return m_impl->Execute(context);
 	}
 
+	ParseRule GetRule() const
+	{
+		return m_impl->GetRule();
+	}
+
 	bool operator==(const ParseInfo& other) const
 	{
 		return m_impl == other.m_impl || m_impl->Equals(*other.m_impl);
@@ -159,10 +173,101 @@ private:
 	std::shared_ptr<Interface> m_impl;
 };
 
+class JoinInfo
+{
+	class Interface
+	{
+	public:
+		bool Equals(const Interface& other) const
+		{
+			return typeid(*this) == typeid(other) && DoEquals(other);
+		}
+
+	protected:
+		virtual bool DoEquals(const Interface& other) const = 0;
+	};
+
+	template<typename... TKeys>
+	class Implementation : public Interface
+	{
+	public:
+		template<typename... TArgs>
+		Implementation(TArgs&&... args)
+			: m_keys(std::forward<TArgs>(args)...)
+		{
+		}
+
+		virtual bool DoEquals(const Interface& other) const override
+		{
+			return m_keys == static_cast<const Implementation<TKeys...>&>(other).m_keys;
+		}
+
+	private:
+		std::tuple<TKeys...> m_keys;
+	};
+
+public:
+	JoinInfo()
+	{
+	}
+
+	template<typename... TArgs>
+	JoinInfo(std::in_place_t, TArgs&&... args)
+		: m_impl(new Implementation<std::decay_t<TArgs>...>(std::forward<TArgs>(args)...))
+	{
+	}
+
+	explicit operator bool() const
+	{
+		return m_impl != nullptr;
+	}
+
+	bool operator==(const JoinInfo& other) const
+	{
+		return m_impl == other.m_impl || (m_impl && other.m_impl && m_impl->Equals(*other.m_impl));
+	}
+
+	bool operator!=(const JoinInfo& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	std::shared_ptr<Interface> m_impl;
+};
+
 class ErrorInfo
 {
 };
 
+template<typename TSyntax>
+class TailCall
+{
+	explicit TailCall(ParseInfo parseInfo)
+		: m_parseInfo(std::move(parseInfo))
+	{
+	}
+
+	ParseInfo m_parseInfo;
+
+	friend struct TailCallAttorney;
+};
+
+struct TailCallAttorney
+{
+	template<typename TSyntax>
+	static TailCall<TSyntax> CreateTailCall(ParseInfo parseInfo)
+	{
+		return TailCall<TSyntax>(std::move(parseInfo));
+	}
+
+	template<typename TSyntax>
+	static ParseInfo TakeParseInfo(TailCall<TSyntax>& tailCall)
+	{
+		return std::move(tailCall.m_parseInfo);
+	}
+};
+
 struct ParseContextAttorney;
 
 template<typename TAwaiter>
@@ -231,7 +336,7 @@ class ParseContextCore
 public:
 	void* Enter(std::size_t coroSize);
 
-	void Suspend_Fork(i32 forkCount);
+	void Suspend_Fork(i32 forkCount, u32 forkMask);
 	i32 Resume_Fork();
 
 	void Suspend_Parse(ParseInfo parseInfo);
@@ -240,7 +345,14 @@ public:
 	void Suspend_Error(ErrorInfo errorInfo);
 	void Resume_Error();
 
+	void Suspend_Commit();
+	void Resume_Commit();
+
+	void Suspend_Join(JoinInfo joinInfo);
+	void Resume_Join();
+
 	void Exit_Ready(Ast::Syntax* syntax);
+	void Exit_Tail(ParseInfo parseInfo);
 	void Exit_Throw();
 
 	static ParseContextCore* GetCore(ParseContext* context);
@@ -295,6 +407,34 @@ public:
 	}
 };
 
+class CommitAwaiter : public AwaiterCore
+{
+public:
+	CommitAwaiter(ParseContextCore* ctx)
+		: AwaiterCore(ctx)
+	{
+	}
+
+	void await_resume()
+	{
+		GetContext()->Resume_Commit();
+	}
+};
+
+class JoinAwaiter : public AwaiterCore
+{
+public:
+	JoinAwaiter(ParseContextCore* ctx)
+		: AwaiterCore(ctx)
+	{
+	}
+
+	void await_resume()
+	{
+		GetContext()->Resume_Join();
+	}
+};
+
 class ParseContext : protected ParseContextCore
 {
 public:
@@ -310,6 +450,19 @@ public:
 		return m_tokens[m_tokenIndex++];
 	}
 
+	// Returns the offset of the bracket matching the bracket at the given offset.
+	// The given offset is returned as is if the token is not a matched bracket.
+	[[nodiscard]] i32 PeekMatchingToken(i32 index = 0)
+	{
+		Assert(m_tokenIndex + index < m_brackets.Size());
+		return m_brackets[m_tokenIndex + index] - m_tokenIndex;
+	}
+
+	[[nodiscard]] const ParseOptions& Options() const
+	{
+		return *m_options;
+	}
+
 	template<typename TSyntax, typename... TArgs>
 	[[nodiscard]] std::enable_if_t<std::is_base_of_v<Ast::Syntax, TSyntax>, TSyntax*> CreateSyntax(TArgs&&... args)
 	{
@@ -324,12 +477,32 @@ public:
 
 	[[nodiscard]] Future<ForkAwaiter> Fork(i32 forkCount)
 	{
-		Assert(forkCount > 1);
-		Suspend_Fork(forkCount);
+		Assert(forkCount > 1 && forkCount <= 32);
+		return Fork(forkCount, ~(u32)0 >> (32 - forkCount));
+	}
+
+	// Alternatives not selected by the mask are never created.
+	// At least one alternative must remain viable.
+	[[nodiscard]] Future<ForkAwaiter> Fork(i32 forkCount, u32 forkMask)
+	{
+		Assert(forkCount > 1 && forkCount <= 32);
+		Assert(forkMask != 0 && (forkMask & ~(~(u32)0 >> (32 - forkCount))) == 0);
+		Suspend_Fork(forkCount, forkMask);
 
 		return FutureAttorney::CreateFuture<ForkAwaiter>(this);
 	}
 
+	// Each predicate is a cheap lookahead test deciding whether the corresponding alternative is viable.
+	template<typename... TPredicates, typename = std::enable_if_t<(std::is_invocable_r_v<bool, TPredicates&, ParseContext*> && ...)>>
+	[[nodiscard]] Future<ForkAwaiter> Fork(TPredicates&&... predicates)
+	{
+		u32 forkMask = 0;
+		u32 forkBit = 1;
+		((forkMask |= predicates(this) ? forkBit : 0, forkBit <<= 1), ...);
+
+		return Fork(sizeof...(TPredicates), forkMask);
+	}
+
 	template<typename TSyntax, typename... TParams, typename... TArgs>
 	[[nodiscard]] Future<ParseAwaiter<TSyntax>> Parse(Result<TSyntax>(*func)(ParseContext*, TParams...), TArgs&&... args)
 	{
@@ -338,6 +511,15 @@ public:
 		return FutureAttorney::CreateFuture<ParseAwaiter<TSyntax>>(this);
 	}
 
+	// Returned with co_return to forward the result of another rule at the current position.
+	// The callee runs in place of the caller, which saves resuming the caller to pass the result on.
+	// Unlike Parse, the callee is not memoized on its own.
+	template<typename TSyntax, typename... TParams, typename... TArgs>
+	[[nodiscard]] TailCall<TSyntax> TailParse(Result<TSyntax>(*func)(ParseContext*, TParams...), TArgs&&... args)
+	{
+		return TailCallAttorney::CreateTailCall<TSyntax>(ParseInfo(func, std::forward<TArgs>(args)...));
+	}
+
 	[[nodiscard]] Future<ErrorAwaiter> SetError()
 	{
 		Suspend_Error(ErrorInfo());
@@ -345,6 +527,26 @@ public:
 		return FutureAttorney::CreateFuture<ErrorAwaiter>(this);
 	}
 
+	// Terminates all other forks of the current frame, along with any frames
+	// which are left without dependants as a result.
+	[[nodiscard]] Future<CommitAwaiter> Commit()
+	{
+		Suspend_Commit();
+
+		return FutureAttorney::CreateFuture<CommitAwaiter>(this);
+	}
+
+	// Merges forks of the current frame which join at the same token index with equal keys.
+	// Only the most preferred of the merged forks is resumed, the others are terminated.
+	// The caller guarantees that forks joining with equal keys have equivalent continuations.
+	template<typename... TArgs>
+	[[nodiscard]] Future<JoinAwaiter> Join(TArgs&&... args)
+	{
+		Suspend_Join(JoinInfo(std::in_place, std::forward<TArgs>(args)...));
+
+		return FutureAttorney::CreateFuture<JoinAwaiter>(this);
+	}
+
 protected:
 	ParseContext()
 	{
@@ -352,7 +554,9 @@ protected:
 
 	i32 m_tokenIndex;
 	Span<Ast::Token* const> m_tokens;
+	Span<const i32> m_brackets;
 	SyntaxTreeContext* m_treeContext;
+	const ParseOptions* m_options;
 
 	friend class ParseContextCore;
 };
@@ -362,12 +566,33 @@ inline ParseContextCore* ParseContextCore::GetCore(ParseContext* context)
 	return context;
 }
 
-Ast::Syntax* ParseCore(Span<Ast::Token*> tokens, SyntaxTreeContext* treeContext, ParseInfo parseInfo);
+// Parse which runs in slices of engine steps. The engine lives on the heap between slices.
+class Session
+{
+public:
+	Session(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseInfo parseInfo);
+	~Session();
+
+	Session(Session&&);
+	Session& operator=(Session&&);
+
+	// Returns true once the parse is finished.
+	bool Step(u64 maxSteps);
+
+	Ast::Syntax* GetResult() const;
+	ParseStatus GetStatus() const;
+
+private:
+	class Engine;
+	std::unique_ptr<Engine> m_engine;
+};
+
+Ast::Syntax* ParseCore(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseStatus* status, ParseInfo parseInfo);
 
 template<typename TSyntax, typename... TParams, typename... TArgs>
-TSyntax* Parse(Span<Ast::Token*> tokens, SyntaxTreeContext* treeContext, Result<TSyntax>(*func)(ParseContext*, TParams...), TArgs&&... args)
+TSyntax* Parse(Span<Ast::Token*> tokens, Span<const i32> brackets, SyntaxTreeContext* treeContext, const ParseOptions& options, ParseStatus* status, Result<TSyntax>(*func)(ParseContext*, TParams...), TArgs&&... args)
 {
-	return static_cast<TSyntax*>(ParseCore(tokens, treeContext, ParseInfo(func, std::forward<TArgs>(args)...)));
+	return static_cast<TSyntax*>(ParseCore(tokens, brackets, treeContext, options, status, ParseInfo(func, std::forward<TArgs>(args)...)));
 }
 
 } // namespace CoroGLL::ParserCore
@@ -405,6 +630,11 @@ struct std::experimental::coroutine_traits<CoroGLL::Private::ParserCore::Result<
 			m_promise.GetContext()->Exit_Ready(syntax);
 		}
 
+		void return_value(CoroGLL::Private::ParserCore::TailCall<TSyntax> tailCall)
+		{
+			m_promise.GetContext()->Exit_Tail(CoroGLL::Private::ParserCore::TailCallAttorney::TakeParseInfo(tailCall));
+		}
+
 		void unhandled_exception()
 		{
 			m_promise.GetContext()->Exit_Throw();
@@ -0,0 +1,452 @@
+#include "ReplayLog.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Core/Debug.hpp"
+
+#include <iterator>
+#include <map>
+#include <utility>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Ast;
+
+namespace {
+
+const char Magic[4] = { 'C', 'G', 'R', 'L' };
+const u8 Version = 2;
+
+enum : u8
+{
+	LeadingTriviaFlag  = 1 << 0,
+	TrailingTriviaFlag = 1 << 1,
+};
+
+void WriteVarint(std::ostream& os, u64 value)
+{
+	while (value >= 0x80)
+	{
+		os.put((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	os.put((char)value);
+}
+
+bool ReadVarint(std::istream& is, u64& value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		int c = is.get();
+		if (c == std::istream::traits_type::eof())
+			return false;
+
+		value |= (u64)(c & 0x7f) << shift;
+		if ((c & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+template<typename T>
+bool ReadVarint(std::istream& is, T& value, u64 max)
+{
+	u64 v;
+	if (!ReadVarint(is, v) || v > max)
+		return false;
+	value = (T)v;
+	return true;
+}
+
+//signed values are biased by one, for the minus one of absent indices
+void WriteIndex(std::ostream& os, i32 value)
+{
+	WriteVarint(os, (u64)((i64)value + 1));
+}
+
+bool ReadIndex(std::istream& is, i32& value)
+{
+	u64 v;
+	if (!ReadVarint(is, v) || v > (u64)INT32_MAX + 1)
+		return false;
+	value = (i32)((i64)v - 1);
+	return true;
+}
+
+bool IsReplayableToken(SyntaxKind kind)
+{
+	switch (kind)
+	{
+	case SyntaxKind::CharLiteralToken:
+	case SyntaxKind::EofToken:
+	case SyntaxKind::NameToken:
+	case SyntaxKind::NumericLiteralToken:
+	case SyntaxKind::StringLiteralToken:
+#define COROGLL_X(n) case SyntaxKind::n ## Symbol:
+	COROGLL_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+#define COROGLL_X(n, s) case SyntaxKind::n ## Keyword:
+	COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+		return true;
+	}
+	return false;
+}
+
+// Forwards the oracle answers, remembering them by the position of the name.
+class RecordingOracle final : public NameOracle
+{
+public:
+	explicit RecordingOracle(NameOracle* oracle)
+		: m_oracle(oracle)
+	{
+	}
+
+	virtual NameKind Classify(WordToken* nameToken) override
+	{
+		NameKind kind = m_oracle->Classify(nameToken);
+		m_kinds[{ nameToken->Pos().Line(), nameToken->Pos().Column() }] = kind;
+		return kind;
+	}
+
+	std::map<std::pair<i32, i32>, NameKind> m_kinds;
+
+private:
+	NameOracle* m_oracle;
+};
+
+// Answers from a log. The synthetic tokens are positioned by their index.
+class ReplayOracle final : public NameOracle
+{
+public:
+	explicit ReplayOracle(const ReplayLog& log)
+		: m_kinds(log.tokens.size(), NameKind::Unknown)
+	{
+		for (const ReplayLog::NameRecord& name : log.names)
+			m_kinds[name.tokenIndex] = name.kind;
+	}
+
+	virtual NameKind Classify(WordToken* nameToken) override
+	{
+		return m_kinds[nameToken->Pos().Column()];
+	}
+
+private:
+	std::vector<NameKind> m_kinds;
+};
+
+class EventRecorder final : public ParseObserver
+{
+public:
+	EventRecorder(std::vector<ReplayLog::EventRecord>* events, ParseObserver* observer)
+		: m_events(events), m_observer(observer)
+	{
+	}
+
+	virtual void OnEvent(const ParseEvent& event) override
+	{
+		m_events->push_back({ event.kind, event.tokenIndex, event.fork });
+
+		if (m_observer != nullptr)
+			m_observer->OnEvent(event);
+	}
+
+private:
+	std::vector<ReplayLog::EventRecord>* m_events;
+	ParseObserver* m_observer;
+};
+
+class EventVerifier final : public ParseObserver
+{
+public:
+	EventVerifier(const std::vector<ReplayLog::EventRecord>& events, ParseObserver* observer)
+		: m_events(events), m_observer(observer)
+	{
+	}
+
+	virtual void OnEvent(const ParseEvent& event) override
+	{
+		if (m_matched)
+		{
+			ReplayLog::EventRecord record = { event.kind, event.tokenIndex, event.fork };
+
+			if (m_index < m_events.size() && m_events[m_index] == record)
+				++m_index;
+			else m_matched = false;
+		}
+
+		if (m_observer != nullptr)
+			m_observer->OnEvent(event);
+	}
+
+	bool IsMatched() const
+	{
+		return m_matched && m_index == m_events.size();
+	}
+
+	u64 Divergence() const
+	{
+		return m_index;
+	}
+
+private:
+	const std::vector<ReplayLog::EventRecord>& m_events;
+	ParseObserver* m_observer;
+
+	u64 m_index = 0;
+	bool m_matched = true;
+};
+
+} // namespace
+
+void CoroGLL::ReplayLog::Write(std::ostream& os) const
+{
+	os.write(Magic, sizeof(Magic));
+	os.put((char)Version);
+
+	os.put((char)engineMode);
+	os.put((char)schedulingPolicy);
+	WriteVarint(os, (u64)maxForksPerFrame);
+	WriteVarint(os, (u64)maxLiveForks);
+	WriteVarint(os, budget.maxSteps);
+	WriteVarint(os, budget.maxLiveFrames);
+	WriteVarint(os, budget.maxCoroutineBytes);
+
+	WriteVarint(os, tokens.size());
+	for (const TokenRecord& token : tokens)
+	{
+		WriteVarint(os, (u64)token.kind);
+		os.put((char)((token.leadingTrivia ? LeadingTriviaFlag : 0) | (token.trailingTrivia ? TrailingTriviaFlag : 0)));
+	}
+
+	WriteVarint(os, names.size());
+	for (const NameRecord& name : names)
+	{
+		WriteIndex(os, name.tokenIndex);
+		os.put((char)name.kind);
+	}
+
+	WriteVarint(os, events.size());
+	for (const EventRecord& event : events)
+	{
+		os.put((char)event.kind);
+		WriteIndex(os, event.tokenIndex);
+		WriteVarint(os, event.fork);
+	}
+}
+
+bool CoroGLL::ReplayLog::Read(std::istream& is)
+{
+	char magic[sizeof(Magic)];
+	if (!is.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), Magic))
+		return false;
+
+	if (is.get() != Version)
+		return false;
+
+	if (!ReadVarint(is, engineMode, (u64)EngineMode::OrderedChoice) ||
+		!ReadVarint(is, schedulingPolicy, (u64)SchedulingPolicy::RoundRobin) ||
+		!ReadVarint(is, maxForksPerFrame, INT32_MAX) ||
+		!ReadVarint(is, maxLiveForks, INT32_MAX) ||
+		!ReadVarint(is, budget.maxSteps) ||
+		!ReadVarint(is, budget.maxLiveFrames) ||
+		!ReadVarint(is, budget.maxCoroutineBytes))
+		return false;
+
+	u64 count;
+
+	if (!ReadVarint(is, count))
+		return false;
+
+	tokens.clear();
+	for (; count != 0; --count)
+	{
+		TokenRecord token;
+		if (!ReadVarint(is, token.kind, Ast::SyntaxKindCount) || !IsReplayableToken(token.kind))
+			return false;
+
+		int flags = is.get();
+		if (flags < 0 || (flags & ~(LeadingTriviaFlag | TrailingTriviaFlag)) != 0)
+			return false;
+
+		token.leadingTrivia = (flags & LeadingTriviaFlag) != 0;
+		token.trailingTrivia = (flags & TrailingTriviaFlag) != 0;
+		tokens.push_back(token);
+	}
+
+	if (tokens.empty() || tokens.back().kind != SyntaxKind::EofToken)
+		return false;
+
+	if (!ReadVarint(is, count))
+		return false;
+
+	names.clear();
+	for (; count != 0; --count)
+	{
+		NameRecord name;
+		if (!ReadIndex(is, name.tokenIndex) || name.tokenIndex < 0 || name.tokenIndex >= (i32)tokens.size() ||
+			!ReadVarint(is, name.kind, (u64)NameKind::Template))
+			return false;
+		names.push_back(name);
+	}
+
+	if (!ReadVarint(is, count))
+		return false;
+
+	events.clear();
+	for (; count != 0; --count)
+	{
+		EventRecord event;
+		if (!ReadVarint(is, event.kind, (u64)ParseEventKind::Exit_Tail) ||
+			!ReadIndex(is, event.tokenIndex) ||
+			!ReadVarint(is, event.fork, UINT32_MAX))
+			return false;
+		events.push_back(event);
+	}
+
+	return true;
+}
+
+SyntaxTree CoroGLL::RecordExpression(std::string_view text, const ParseOptions& options, ReplayLog* log)
+{
+	log->engineMode = options.engineMode;
+	log->schedulingPolicy = options.schedulingPolicy;
+	log->maxForksPerFrame = options.maxForksPerFrame;
+	log->maxLiveForks = options.maxLiveForks;
+	log->budget = options.budget;
+	log->budget.maxArenaBytes = 0;
+
+	log->events.clear();
+	EventRecorder recorder(&log->events, options.observer);
+
+	ParseOptions recordOptions = options;
+	recordOptions.observer = &recorder;
+
+	//without an oracle the grammar treats every name as unknown, as does the replay
+	RecordingOracle oracle(options.nameOracle);
+	if (options.nameOracle != nullptr)
+		recordOptions.nameOracle = &oracle;
+
+	//parses like ParseExpression, keeping the tokens for the log
+	ParseStats* stats = EnableParseStats ? options.stats : nullptr;
+	if (stats != nullptr)
+		*stats = ParseStats();
+
+	Private::SyntaxTreeContext treeContext;
+	std::vector<Token*> tokenVector = Private::Lex(text, &treeContext, stats);
+
+	Span<Token*> tokens(tokenVector.data(), tokenVector.size());
+	std::vector<i32> bracketVector = Private::MatchBrackets(tokens, stats);
+
+	ParseStatus status;
+	Syntax* syntax;
+	{
+		Private::StatsTimer timer(stats != nullptr ? &stats->parseNanoseconds : nullptr);
+		syntax = Private::ParseExpression(tokens, Span<const i32>(bracketVector.data(), bracketVector.size()),
+			&treeContext, recordOptions, &status);
+	}
+
+	std::map<std::pair<i32, i32>, i32> tokenIndices;
+
+	log->tokens.clear();
+	for (i32 index = 0; index < (i32)tokens.Size(); ++index)
+	{
+		Token* token = tokens[index];
+		log->tokens.push_back({ token->Kind(), token->LeadingTrivia().Size() != 0, token->TrailingTrivia().Size() != 0 });
+		tokenIndices[{ token->Pos().Line(), token->Pos().Column() }] = index;
+	}
+
+	log->names.clear();
+	for (const auto& [pos, kind] : oracle.m_kinds)
+		log->names.push_back({ tokenIndices.at(pos), kind });
+
+	return Private::SyntaxTreeAttorney::CreateSyntaxTree(syntax, status, std::move(treeContext));
+}
+
+bool CoroGLL::ReplayExpression(const ReplayLog& log, const ParseOptions& options, u64* divergence)
+{
+	Private::SyntaxTreeContext treeContext;
+
+	//all separated tokens share a single trivia
+	Trivia* trivia = treeContext.CreateSyntax<WhiteSpaceTrivia>(SourcePos(0, 0), " ", "");
+	Span<Trivia*> triviaList = treeContext.CreateSyntaxList<Trivia>(&trivia, &trivia + 1);
+
+	std::vector<Token*> tokenVector;
+	tokenVector.reserve(log.tokens.size());
+
+	for (i32 index = 0; index < (i32)log.tokens.size(); ++index)
+	{
+		const ReplayLog::TokenRecord& record = log.tokens[index];
+
+		TokenInfo tokenInfo{ SourcePos(0, index),
+			record.leadingTrivia ? triviaList : Span<Trivia*>(),
+			record.trailingTrivia ? triviaList : Span<Trivia*>() };
+
+		Token* token;
+		switch (record.kind)
+		{
+		case SyntaxKind::CharLiteralToken:
+			token = treeContext.CreateSyntax<CharLiteralToken>(tokenInfo, "a", nullptr);
+			break;
+
+		case SyntaxKind::EofToken:
+			token = treeContext.CreateSyntax<EofToken>(tokenInfo);
+			break;
+
+		case SyntaxKind::NameToken:
+			token = treeContext.CreateSyntax<NameToken>(tokenInfo, "a", false);
+			break;
+
+		case SyntaxKind::NumericLiteralToken:
+			token = treeContext.CreateSyntax<NumericLiteralToken>(tokenInfo, Rational(), nullptr);
+			break;
+
+		case SyntaxKind::StringLiteralToken:
+			token = treeContext.CreateSyntax<StringLiteralToken>(tokenInfo, "", nullptr);
+			break;
+
+#define COROGLL_X(n) case SyntaxKind::n ## Symbol:
+		COROGLL_SYMBOL(COROGLL_X)
+#undef COROGLL_X
+			token = treeContext.CreateSyntax<SymbolToken>(tokenInfo, (Symbol)record.kind);
+			break;
+
+#define COROGLL_X(n, s) case SyntaxKind::n ## Keyword:
+		COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+			token = treeContext.CreateSyntax<KeywordToken>(tokenInfo, (Keyword)record.kind);
+			break;
+
+		default:
+			Assert(false);
+			return false;
+		}
+
+		tokenVector.push_back(token);
+	}
+
+	Span<Token*> tokens(tokenVector.data(), tokenVector.size());
+	std::vector<i32> bracketVector = Private::MatchBrackets(tokens);
+
+	EventVerifier verifier(log.events, options.observer);
+	ReplayOracle oracle(log);
+
+	ParseOptions replayOptions = options;
+	replayOptions.engineMode = log.engineMode;
+	replayOptions.schedulingPolicy = log.schedulingPolicy;
+	replayOptions.maxForksPerFrame = log.maxForksPerFrame;
+	replayOptions.maxLiveForks = log.maxLiveForks;
+	replayOptions.budget.maxSteps = log.budget.maxSteps;
+	replayOptions.budget.maxLiveFrames = log.budget.maxLiveFrames;
+	replayOptions.budget.maxCoroutineBytes = log.budget.maxCoroutineBytes;
+	replayOptions.nameOracle = &oracle;
+	replayOptions.observer = &verifier;
+
+	ParseStatus status;
+	Private::ParseExpression(tokens, Span<const i32>(bracketVector.data(), bracketVector.size()),
+		&treeContext, replayOptions, &status);
+
+	if (divergence != nullptr)
+		*divergence = verifier.Divergence();
+
+	return verifier.IsMatched();
+}
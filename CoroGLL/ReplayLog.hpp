@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ParseObserver.hpp"
+#include "ParseOptions.hpp"
+#include "SyntaxTree.hpp"
+#include "Syntax/SyntaxKind.hpp"
+
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace CoroGLL {
+
+// Anonymized record of an expression parse, from which its schedule can be
+// reproduced without the source text. Names and literal values are not kept,
+// only the kind of each token and whether it is separated from its neighbours.
+struct ReplayLog
+{
+	struct TokenRecord
+	{
+		Ast::SyntaxKind kind;
+		bool leadingTrivia;
+		bool trailingTrivia;
+	};
+
+	// answer of the name oracle for the name token at an index.
+	struct NameRecord
+	{
+		i32 tokenIndex;
+		NameKind kind;
+	};
+
+	struct EventRecord
+	{
+		ParseEventKind kind;
+		i32 tokenIndex;
+		u32 fork;
+
+		bool operator==(const EventRecord& other) const
+		{
+			return kind == other.kind && tokenIndex == other.tokenIndex && fork == other.fork;
+		}
+	};
+
+	// options affecting the schedule. a custom operator table is not recorded.
+	// the arena budget is not recorded either, as the synthetic tokens of a
+	// replay differ in size from the lexed ones, so it cannot be reproduced exactly.
+	EngineMode engineMode = EngineMode::Generalized;
+	SchedulingPolicy schedulingPolicy = SchedulingPolicy::LeastAdvanced;
+	i32 maxForksPerFrame = 0;
+	i32 maxLiveForks = 0;
+	ParseBudget budget;
+
+	std::vector<TokenRecord> tokens;
+	std::vector<NameRecord> names;
+	std::vector<EventRecord> events;
+
+	// Compact binary encoding.
+	void Write(std::ostream& os) const;
+	bool Read(std::istream& is);
+};
+
+// Parses like ParseExpression, recording the log of the parse.
+SyntaxTree RecordExpression(std::string_view text, const ParseOptions& options, ReplayLog* log);
+
+// Parses synthetic tokens of the kinds in a log, with the options it was recorded with,
+// taking the operator table, arena budget, cancellation, stats and observer from the given options.
+// Returns whether the schedule matched the log. The divergence, if requested,
+// receives the index of the first differing event, or the number of events.
+bool ReplayExpression(const ReplayLog& log, const ParseOptions& options, u64* divergence = nullptr);
+
+} // namespace CoroGLL
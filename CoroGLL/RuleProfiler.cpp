@@ -0,0 +1,137 @@
+#include "RuleProfiler.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace CoroGLL;
+
+void CoroGLL::RuleProfiler::OnEvent(const ParseEvent& event)
+{
+	switch (event.kind)
+	{
+	case ParseEventKind::CreateFrame:
+		++GetProfile(event.rule).invocations;
+		m_frameStarts[event.frame] = Clock::now();
+		break;
+
+	case ParseEventKind::MemoHit:
+		++GetProfile(event.rule).memoHits;
+		break;
+
+	case ParseEventKind::ReadyFrame:
+	case ParseEventKind::FailFrame:
+		{
+			RuleProfile& profile = GetProfile(event.rule);
+
+			if (event.kind == ParseEventKind::FailFrame)
+				++profile.errors;
+
+			if (auto it = m_frameStarts.find(event.frame); it != m_frameStarts.end())
+			{
+				profile.inclusiveNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - it->second).count();
+				m_frameStarts.erase(it);
+			}
+		}
+		break;
+
+	case ParseEventKind::DiscardFrame:
+		m_frameStarts.erase(event.frame);
+		break;
+
+	case ParseEventKind::CreateFork:
+		{
+			//includes the initial fork of each frame, which is subtracted on report
+			RuleProfile& profile = GetProfile(event.rule);
+			++profile.forks;
+			profile.maxCoroutineBytes = std::max(profile.maxCoroutineBytes, (u64)event.coroutineBytes);
+		}
+		break;
+
+	case ParseEventKind::TerminateFork:
+		break;
+
+	case ParseEventKind::Resume:
+		m_resumeStart = Clock::now();
+		break;
+
+	case ParseEventKind::Suspend_Fork:
+	case ParseEventKind::Suspend_Parse:
+	case ParseEventKind::Suspend_Error:
+	case ParseEventKind::Suspend_Commit:
+	case ParseEventKind::Suspend_Join:
+	case ParseEventKind::Exit_Ready:
+	case ParseEventKind::Exit_Tail:
+		{
+			RuleProfile& profile = GetProfile(event.rule);
+			profile.selfNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_resumeStart).count();
+			profile.maxCoroutineBytes = std::max(profile.maxCoroutineBytes, (u64)event.coroutineBytes);
+		}
+		break;
+	}
+}
+
+std::vector<RuleProfile> CoroGLL::RuleProfiler::GetProfiles() const
+{
+	std::vector<RuleProfile> profiles;
+	profiles.reserve(m_profiles.size());
+
+	for (const auto& [rule, profile] : m_profiles)
+	{
+		profiles.push_back(profile);
+
+		RuleProfile& back = profiles.back();
+		back.forks -= std::min(back.forks, back.invocations);
+	}
+
+	std::sort(profiles.begin(), profiles.end(), [](const RuleProfile& a, const RuleProfile& b)
+	{
+		return a.selfNanoseconds > b.selfNanoseconds;
+	});
+
+	return profiles;
+}
+
+void CoroGLL::RuleProfiler::WriteReport(std::ostream& os) const
+{
+	std::ios::fmtflags flags = os.flags();
+
+	os << std::left << std::setw(32) << "rule" << std::right
+		<< std::setw(10) << "calls"
+		<< std::setw(10) << "hits"
+		<< std::setw(8) << "hit%"
+		<< std::setw(10) << "forks"
+		<< std::setw(10) << "errors"
+		<< std::setw(8) << "bytes"
+		<< std::setw(12) << "self us"
+		<< std::setw(12) << "incl us" << '\n';
+
+	for (const RuleProfile& profile : GetProfiles())
+	{
+		os << std::left << std::setw(32) << GetRuleName(profile.rule) << std::right
+			<< std::setw(10) << profile.invocations
+			<< std::setw(10) << profile.memoHits
+			<< std::setw(8) << std::fixed << std::setprecision(1) << profile.MemoHitRate() * 100
+			<< std::setw(10) << profile.forks
+			<< std::setw(10) << profile.errors
+			<< std::setw(8) << profile.maxCoroutineBytes
+			<< std::setw(12) << std::setprecision(3) << profile.selfNanoseconds / 1000.0
+			<< std::setw(12) << profile.inclusiveNanoseconds / 1000.0 << '\n';
+	}
+
+	os.flags(flags);
+}
+
+void CoroGLL::RuleProfiler::Clear()
+{
+	m_profiles.clear();
+	m_frameStarts.clear();
+}
+
+RuleProfile& CoroGLL::RuleProfiler::GetProfile(ParseRule rule)
+{
+	auto [it, inserted] = m_profiles.try_emplace(rule);
+	if (inserted)
+		it->second.rule = rule;
+	return it->second;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ParseObserver.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace CoroGLL {
+
+// Counters and timings of a grammar rule, aggregated over the observed parses.
+struct RuleProfile
+{
+	ParseRule rule = nullptr;
+
+	// frames created for the rule, that is memo misses.
+	u64 invocations = 0;
+
+	// parse requests answered by an existing frame of the rule.
+	u64 memoHits = 0;
+
+	// forks created by forking within the rule, not counting initial forks.
+	u64 forks = 0;
+
+	// frames of the rule which failed.
+	u64 errors = 0;
+
+	// largest coroutine frame of the rule.
+	u64 maxCoroutineBytes = 0;
+
+	// time spent running forks of the rule. a rule exiting by tail parse
+	// is charged for the callee running in its place.
+	u64 selfNanoseconds = 0;
+
+	// time from the creation of each frame of the rule until it completed or
+	// failed, including the dependencies and any work interleaved with them.
+	u64 inclusiveNanoseconds = 0;
+
+	double MemoHitRate() const
+	{
+		u64 requests = invocations + memoHits;
+		return requests != 0 ? (double)memoHits / requests : 0;
+	}
+};
+
+// Aggregates the events of one or more parses into a profile for each rule.
+class RuleProfiler final : public ParseObserver
+{
+public:
+	virtual void OnEvent(const ParseEvent& event) override;
+
+	// Profiles of the observed rules, sorted by descending self time.
+	std::vector<RuleProfile> GetProfiles() const;
+
+	void WriteReport(std::ostream& os) const;
+
+	void Clear();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	RuleProfile& GetProfile(ParseRule rule);
+
+	std::unordered_map<ParseRule, RuleProfile> m_profiles;
+
+	//start of the frames still pending
+	std::unordered_map<u32, Clock::time_point> m_frameStarts;
+
+	//start of the running fork, forks never run concurrently
+	Clock::time_point m_resumeStart;
+};
+
+} // namespace CoroGLL
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SyntaxKind.hpp"
+#include "../Core/Types.hpp"
+
+#include <initializer_list>
+
+namespace CoroGLL::Ast
+{
+	constexpr u32 SyntaxKindCount = 1
+#define COROGLL_X(n) + 1
+		COROGLL_TRIVIA(COROGLL_X)
+		COROGLL_TOKEN(COROGLL_X)
+		COROGLL_SYMBOL(COROGLL_X)
+		COROGLL_EXPRESSION(COROGLL_X)
+		COROGLL_UNARY_OPERATOR(COROGLL_X)
+		COROGLL_BINARY_OPERATOR(COROGLL_X)
+		COROGLL_INVOKE_OPERATOR(COROGLL_X)
+		COROGLL_ACCESS_OPERATOR(COROGLL_X)
+		COROGLL_SYNTAX(COROGLL_X)
+#undef COROGLL_X
+#define COROGLL_X(n, s) + 1
+		COROGLL_KEYWORD(COROGLL_X)
+#undef COROGLL_X
+		;
+
+	// Fixed size bit set of syntax kinds, usable in constant expressions.
+	class SyntaxKindSet
+	{
+		static constexpr u32 WordSize = 64;
+		static constexpr u32 WordCount = (SyntaxKindCount + WordSize - 1) / WordSize;
+
+	public:
+		constexpr SyntaxKindSet()
+			: m_words{}
+		{
+		}
+
+		constexpr SyntaxKindSet(std::initializer_list<SyntaxKind> syntaxKinds)
+			: m_words{}
+		{
+			for (SyntaxKind syntaxKind : syntaxKinds)
+				Insert(syntaxKind);
+		}
+
+		constexpr void Insert(SyntaxKind syntaxKind)
+		{
+			m_words[(u32)syntaxKind / WordSize] |= (u64)1 << ((u32)syntaxKind % WordSize);
+		}
+
+		constexpr bool Contains(SyntaxKind syntaxKind) const
+		{
+			return (m_words[(u32)syntaxKind / WordSize] >> ((u32)syntaxKind % WordSize) & 1) != 0;
+		}
+
+		constexpr SyntaxKindSet operator|(const SyntaxKindSet& other) const
+		{
+			SyntaxKindSet result;
+			for (u32 i = 0; i < WordCount; ++i)
+				result.m_words[i] = m_words[i] | other.m_words[i];
+			return result;
+		}
+
+	private:
+		u64 m_words[WordCount];
+	};
+}
@@ -63,7 +63,7 @@ struct CoroGLL::Private::SyntaxTreeContext::First : RefCountBase, Block
 };
 
 CoroGLL::Private::SyntaxTreeContext::SyntaxTreeContext()
-	: m_head(nullptr)
+	: m_head(nullptr), m_allocatedBytes(0), m_allocationCount(0)
 {
 }
 
@@ -74,7 +74,7 @@ CoroGLL::Private::SyntaxTreeContext::~SyntaxTreeContext()
 }
 
 CoroGLL::Private::SyntaxTreeContext::SyntaxTreeContext(SyntaxTreeContext&& other)
-	: m_head(other.m_head), m_tail(other.m_tail)
+	: m_head(other.m_head), m_tail(other.m_tail), m_allocatedBytes(other.m_allocatedBytes), m_allocationCount(other.m_allocationCount)
 {
 	other.m_head = nullptr;
 }
@@ -86,6 +86,8 @@ CoroGLL::Private::SyntaxTreeContext& CoroGLL::Private::SyntaxTreeContext::operat
 
 	m_head = other.m_head;
 	m_tail = other.m_tail;
+	m_allocatedBytes = other.m_allocatedBytes;
+	m_allocationCount = other.m_allocationCount;
 
 	other.m_head = nullptr;
 
@@ -93,7 +95,7 @@ CoroGLL::Private::SyntaxTreeContext& CoroGLL::Private::SyntaxTreeContext::operat
 }
 
 CoroGLL::Private::SyntaxTreeContext::SyntaxTreeContext(const SyntaxTreeContext& other)
-	: m_head(other.m_head), m_tail(other.m_tail)
+	: m_head(other.m_head), m_tail(other.m_tail), m_allocatedBytes(other.m_allocatedBytes), m_allocationCount(other.m_allocationCount)
 {
 	if (m_head) std::atomic_fetch_add_explicit(&m_head->RefCount, 1, std::memory_order_relaxed);
 }
@@ -105,6 +107,8 @@ CoroGLL::Private::SyntaxTreeContext& CoroGLL::Private::SyntaxTreeContext::operat
 
 	m_head = other.m_head;
 	m_tail = other.m_tail;
+	m_allocatedBytes = other.m_allocatedBytes;
+	m_allocationCount = other.m_allocationCount;
 
 	if (m_head) std::atomic_fetch_add_explicit(&m_head->RefCount, 1, std::memory_order_relaxed);
 
@@ -152,6 +156,9 @@ void CoroGLL::Private::SyntaxTreeContext::Clean(First* first)
 
 void* CoroGLL::Private::SyntaxTreeContext::Allocate(uword size, uword align)
 {
+	m_allocatedBytes += size;
+	++m_allocationCount;
+
 	//HACK: something is broken
 	return std::malloc(size);
 
@@ -54,6 +54,18 @@ public:
 
 	void Reset();
 
+	// total size of all allocations made through this context.
+	uword AllocatedBytes() const
+	{
+		return m_allocatedBytes;
+	}
+
+	// number of allocations made through this context.
+	uword AllocationCount() const
+	{
+		return m_allocationCount;
+	}
+
 private:
 	struct First;
 	struct Block;
@@ -64,6 +76,9 @@ private:
 
 	First* m_head;
 	Block* m_tail;
+
+	uword m_allocatedBytes;
+	uword m_allocationCount;
 };
 
 struct SyntaxTreeAttorney;
@@ -72,6 +87,28 @@ struct SyntaxTreeAttorney;
 
 namespace CoroGLL {
 
+enum class ParseStatus
+{
+	Complete,
+
+	// the input was rejected. there is no tree.
+	Error,
+
+	// alternatives were dropped to stay within the fork limits.
+	// the tree is the best one among the remaining alternatives.
+	Truncated,
+
+	// the parse was abandoned for exceeding its budget. there is no tree.
+	StepBudgetExceeded,
+	FrameBudgetExceeded,
+	CoroutineBudgetExceeded,
+	ArenaBudgetExceeded,
+
+	// the parse was abandoned through its cancellation token,
+	// or by destroying its unfinished session. there is no tree.
+	Cancelled,
+};
+
 class SyntaxTree
 {
 public:
@@ -80,13 +117,19 @@ public:
 		return m_root;
 	}
 
+	ParseStatus GetStatus() const
+	{
+		return m_status;
+	}
+
 private:
-	SyntaxTree(Ast::Syntax* root, Private::SyntaxTreeContext ctx)
-		: m_root(root), m_context(std::move(ctx))
+	SyntaxTree(Ast::Syntax* root, ParseStatus status, Private::SyntaxTreeContext ctx)
+		: m_root(root), m_status(status), m_context(std::move(ctx))
 	{
 	}
 
 	Ast::Syntax* m_root;
+	ParseStatus m_status;
 	Private::SyntaxTreeContext m_context;
 
 	friend struct Private::SyntaxTreeAttorney;
@@ -96,8 +139,8 @@ private:
 
 struct CoroGLL::Private::SyntaxTreeAttorney
 {
-	static SyntaxTree CreateSyntaxTree(Ast::Syntax* root, SyntaxTreeContext&& ctx)
+	static SyntaxTree CreateSyntaxTree(Ast::Syntax* root, ParseStatus status, SyntaxTreeContext&& ctx)
 	{
-		return SyntaxTree(root, std::move(ctx));
+		return SyntaxTree(root, status, std::move(ctx));
 	}
 };
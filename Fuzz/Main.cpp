@@ -0,0 +1,89 @@
+#include "Parser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+using namespace CoroGLL;
+
+namespace {
+
+// Work allowed for each byte of input, on top of a fixed allowance for short inputs.
+// Well behaved expressions stay far below these; see Bench --scaling.
+// An input exceeding them is reported as a finding, like a crash.
+constexpr u64 StepsPerByte = 64;
+constexpr u64 LiveFramesPerByte = 8;
+constexpr u64 CoroutineBytesPerByte = 1024;
+constexpr u64 ArenaBytesPerByte = 1024;
+constexpr u64 FixedAllowance = 64;
+
+const char* GetBudgetName(ParseStatus status)
+{
+	switch (status)
+	{
+	case ParseStatus::StepBudgetExceeded: return "steps";
+	case ParseStatus::FrameBudgetExceeded: return "live frames";
+	case ParseStatus::CoroutineBudgetExceeded: return "coroutine bytes";
+	case ParseStatus::ArenaBudgetExceeded: return "arena bytes";
+	}
+	return nullptr;
+}
+
+} // namespace
+
+// Parses the input as an expression under a budget proportional to its size.
+// Crashes are findings as usual, and so is exceeding the budget, which aborts.
+// Rejected inputs are not findings, their parse finishes with ParseStatus::Error.
+// Run with -artifact_prefix=Fuzz/Pathological/ to collect the pathological
+// inputs there, and minimize them with -minimize_crash=1.
+// The engine relies on the coroutines TS of MSVC, whose libFuzzer needs an x64 target:
+//   cl /std:c++latest /await /EHsc /Zi /fsanitize=address /fsanitize=fuzzer /ICoroGLL CoroGLL\*.cpp CoroGLL\Syntax\*.cpp Fuzz\Main.cpp
+// Define COROGLL_FUZZ_STANDALONE to build a driver without libFuzzer, which
+// runs the input files given on the command line.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	std::string_view text(reinterpret_cast<const char*>(data), size);
+	u64 allowance = size + FixedAllowance;
+
+	ParseOptions options;
+	options.budget.maxSteps = StepsPerByte * allowance;
+	options.budget.maxLiveFrames = LiveFramesPerByte * allowance;
+	options.budget.maxCoroutineBytes = CoroutineBytesPerByte * allowance;
+	options.budget.maxArenaBytes = ArenaBytesPerByte * allowance;
+
+	SyntaxTree tree = ParseExpression(text, options);
+
+	if (const char* budget = GetBudgetName(tree.GetStatus()))
+	{
+		std::fprintf(stderr, "exceeded the %s budget for %zu bytes of input\n", budget, size);
+		std::abort();
+	}
+
+	return 0;
+}
+
+#ifdef COROGLL_FUZZ_STANDALONE
+int main(int argc, char** argv)
+{
+	for (int index = 1; index < argc; ++index)
+	{
+		FILE* file = std::fopen(argv[index], "rb");
+		if (file == nullptr)
+		{
+			std::fprintf(stderr, "cannot open %s\n", argv[index]);
+			return 1;
+		}
+
+		std::string text;
+		char buffer[4096];
+		for (size_t size; (size = std::fread(buffer, 1, sizeof(buffer), file)) != 0;)
+			text.append(buffer, size);
+		std::fclose(file);
+
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+	}
+}
+#endif
@@ -0,0 +1,152 @@
+#include "Benchmark.hpp"
+
+#include "Lexer.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+using namespace CoroGLL;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Measurement
+{
+	u64 bytes = 0;
+	u64 tokens = 0;
+
+	//of each timed parse, in nanoseconds
+	std::vector<u64> latencies;
+};
+
+// nearest rank percentile of sorted latencies.
+u64 Percentile(const std::vector<u64>& latencies, double percentile)
+{
+	if (latencies.empty())
+		return 0;
+
+	size_t rank = (size_t)std::ceil(percentile / 100 * latencies.size());
+	return latencies[std::clamp<size_t>(rank, 1, latencies.size()) - 1];
+}
+
+void WriteHeader(std::ostream& os)
+{
+	os << std::setw(10) << "bytes"
+		<< std::setw(10) << "tokens"
+		<< std::setw(12) << "MB/s"
+		<< std::setw(12) << "Mtok/s"
+		<< std::setw(12) << "p50 us"
+		<< std::setw(12) << "p90 us"
+		<< std::setw(12) << "p99 us"
+		<< std::setw(12) << "max us"
+		<< "  file\n";
+}
+
+void WriteMeasurement(std::ostream& os, std::string_view name, Measurement& measurement)
+{
+	std::sort(measurement.latencies.begin(), measurement.latencies.end());
+
+	u64 nanoseconds = 0;
+	for (u64 latency : measurement.latencies)
+		nanoseconds += latency;
+
+	u64 iterations = measurement.latencies.size();
+	auto perSecond = [&](u64 count) { return nanoseconds != 0 ? count * iterations * 1e3 / nanoseconds : 0; };
+
+	os << std::fixed << std::setprecision(2)
+		<< std::setw(10) << measurement.bytes
+		<< std::setw(10) << measurement.tokens
+		<< std::setw(12) << perSecond(measurement.bytes)
+		<< std::setw(12) << perSecond(measurement.tokens)
+		<< std::setw(12) << Percentile(measurement.latencies, 50) / 1e3
+		<< std::setw(12) << Percentile(measurement.latencies, 90) / 1e3
+		<< std::setw(12) << Percentile(measurement.latencies, 99) / 1e3
+		<< std::setw(12) << (iterations != 0 ? measurement.latencies.back() / 1e3 : 0)
+		<< "  " << name << '\n';
+}
+
+} // namespace
+
+bool CollectFiles(const std::vector<std::string>& paths, std::vector<std::string>* files)
+{
+	namespace fs = std::filesystem;
+
+	for (const std::string& path : paths)
+	{
+		std::error_code error;
+		if (fs::is_directory(path, error))
+		{
+			std::vector<std::string> entries;
+			for (const fs::directory_entry& entry : fs::directory_iterator(path, error))
+			{
+				if (entry.is_regular_file())
+					entries.push_back(entry.path().string());
+			}
+
+			std::sort(entries.begin(), entries.end());
+			files->insert(files->end(), entries.begin(), entries.end());
+		}
+		else if (fs::exists(path, error))
+		{
+			files->push_back(path);
+		}
+		else
+		{
+			std::cerr << "cannot find " << path << '\n';
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RunBenchmark(std::ostream& os, const std::vector<std::string>& files, const BenchmarkOptions& benchmarkOptions, const ParseOptions& options)
+{
+	WriteHeader(os);
+
+	Measurement total;
+	for (const std::string& path : files)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "cannot open " << path << '\n';
+			return false;
+		}
+
+		std::string source(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>{});
+
+		Measurement measurement;
+		measurement.bytes = source.size();
+		measurement.tokens = Lex(source).Count();
+
+		for (i32 index = 0; index < benchmarkOptions.warmup; ++index)
+			ParseExpression(source, options);
+
+		for (i32 index = 0; index < benchmarkOptions.iterations; ++index)
+		{
+			auto start = Clock::now();
+			SyntaxTree tree = ParseExpression(source, options);
+			measurement.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		}
+
+		//the total treats the files as one input per iteration
+		total.bytes += measurement.bytes;
+		total.tokens += measurement.tokens;
+		total.latencies.resize(measurement.latencies.size());
+		for (size_t index = 0; index < measurement.latencies.size(); ++index)
+			total.latencies[index] += measurement.latencies[index];
+
+		WriteMeasurement(os, path, measurement);
+	}
+
+	WriteMeasurement(os, "total", total);
+	return true;
+}
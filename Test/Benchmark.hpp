@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ParseOptions.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions
+{
+	// untimed parses of each file before measuring.
+	CoroGLL::i32 warmup = 1;
+
+	// timed parses of each file.
+	CoroGLL::i32 iterations = 10;
+};
+
+// Expands directories into the regular files they contain, in name order.
+// Returns false if a path does not exist.
+bool CollectFiles(const std::vector<std::string>& paths, std::vector<std::string>* files);
+
+// Parses each file repeatedly and reports its throughput and latency
+// percentiles, followed by the totals. Returns false if a file cannot be read.
+bool RunBenchmark(std::ostream& os, const std::vector<std::string>& files, const BenchmarkOptions& benchmarkOptions, const CoroGLL::ParseOptions& options);
@@ -0,0 +1,372 @@
+#include "EngineTests.hpp"
+
+#include "Lexer.hpp"
+#include "ParserCore.hpp"
+#include "Syntax/Expression.hpp"
+
+#include <string_view>
+#include <vector>
+
+using namespace CoroGLL;
+using namespace CoroGLL::Ast;
+
+using CoroGLL::Private::ParserCore::Result;
+using CoroGLL::Private::ParserCore::ParseContext;
+
+typedef ParseContext Ctx;
+
+namespace {
+
+constexpr i32 ParseEventKindCount = 0
+#define COROGLL_X(n) + 1
+	COROGLL_PARSE_EVENT(COROGLL_X)
+#undef COROGLL_X
+;
+
+// counts the events of each kind.
+class EventCounter final : public ParseObserver
+{
+public:
+	virtual void OnEvent(const ParseEvent& event) override
+	{
+		++m_counts[(i32)event.kind];
+	}
+
+	u64 Count(ParseEventKind kind) const
+	{
+		return m_counts[(i32)kind];
+	}
+
+private:
+	u64 m_counts[ParseEventKindCount] = {};
+};
+
+struct TestParse
+{
+	explicit TestParse(std::string_view text)
+		: tokenVector(Private::Lex(text, &treeContext))
+		, bracketVector(Private::MatchBrackets(Span<Token*>(tokenVector.data(), tokenVector.size())))
+	{
+		options.observer = &events;
+	}
+
+	template<typename TSyntax, typename... TParams, typename... TArgs>
+	TSyntax* Parse(Result<TSyntax>(*func)(Ctx*, TParams...), TArgs&&... args)
+	{
+		return Private::ParserCore::Parse(Span<Token*>(tokenVector.data(), tokenVector.size()), Span<const i32>(bracketVector.data(), bracketVector.size()),
+			&treeContext, options, &status, func, std::forward<TArgs>(args)...);
+	}
+
+	template<typename TSyntax, typename... TParams, typename... TArgs>
+	Private::ParserCore::Session Start(Result<TSyntax>(*func)(Ctx*, TParams...), TArgs&&... args)
+	{
+		return Private::ParserCore::Session(Span<Token*>(tokenVector.data(), tokenVector.size()), Span<const i32>(bracketVector.data(), bracketVector.size()),
+			&treeContext, options, Private::ParserCore::ParseInfo(func, std::forward<TArgs>(args)...));
+	}
+
+	Private::SyntaxTreeContext treeContext;
+	std::vector<Token*> tokenVector;
+	std::vector<i32> bracketVector;
+
+	EventCounter events;
+	ParseOptions options;
+	ParseStatus status = ParseStatus::Complete;
+};
+
+class TestContext
+{
+public:
+	explicit TestContext(std::ostream& os)
+		: m_os(&os)
+	{
+	}
+
+	void Check(bool condition, const char* test, const char* description)
+	{
+		if (!condition)
+		{
+			*m_os << test << ": " << description << '\n';
+			m_success = false;
+		}
+	}
+
+	bool Success() const
+	{
+		return m_success;
+	}
+
+private:
+	std::ostream* m_os;
+	bool m_success = true;
+};
+
+// number of times an alternative ran past the point where it should have been cut off.
+i32 lateAlternatives;
+
+// alternatives which continued past a join point, by index.
+std::vector<i32> joinedAlternatives;
+
+Expression* CreateWord(Ctx* ctx)
+{
+	return ctx->CreateSyntax<WordExpression>(static_cast<WordToken*>(ctx->EatToken()));
+}
+
+// parses the given number of words, one frame for each.
+Result<Expression> ParseWords(Ctx* ctx, i32 count)
+{
+	Expression* expression = CreateWord(ctx);
+
+	if (count > 1)
+		expression = co_await ctx->Parse(ParseWords, count - 1);
+
+	co_return expression;
+}
+
+// either parses the words in a single chain of frames, or takes one word
+// and recurses. every input of the given number of words is ambiguous.
+Result<Expression> ParseAmbiguous(Ctx* ctx, i32 count)
+{
+	if (co_await ctx->Fork(2) == 0)
+		co_return co_await ctx->Parse(ParseWords, count);
+
+	Expression* expression = CreateWord(ctx);
+
+	if (count > 1)
+		expression = co_await ctx->Parse(ParseAmbiguous, count - 1);
+
+	co_return expression;
+}
+
+// the preferred alternative waits on a chain of frames. the second commits
+// after a single word, ahead of the first, which would otherwise win.
+Result<Expression> ParseCommitted(Ctx* ctx)
+{
+	switch (co_await ctx->Fork(3))
+	{
+	case 0:
+		co_return co_await ctx->Parse(ParseWords, 3);
+
+	case 1:
+		{
+			Expression* expression = CreateWord(ctx);
+			co_await ctx->Commit();
+			co_return expression;
+		}
+
+	case 2:
+		++lateAlternatives;
+		co_return CreateWord(ctx);
+	}
+
+	co_return nullptr;
+}
+
+// both alternatives consume the same word and converge on the same key,
+// after which only one of them may continue to the next word.
+Result<Expression> ParseJoined(Ctx* ctx)
+{
+	i32 alternative = co_await ctx->Fork(2);
+
+	//the less preferred alternative takes a detour through a frame, arriving later
+	Expression* expression = alternative == 0
+		? CreateWord(ctx)
+		: co_await ctx->Parse(ParseWords, 1);
+
+	co_await ctx->Join(ctx->PeekToken()->Kind());
+	joinedAlternatives.push_back(alternative);
+
+	//without the join, the less preferred fork catches up here
+	Expression* next = co_await ctx->Parse(ParseWords, 1);
+	co_return ctx->CreateSyntax<BinaryExpression>(BinaryOperator::LessThan, expression, nullptr, next);
+}
+
+void TestJoin(TestContext& test)
+{
+	const char* name = "join";
+
+	TestParse parse("a b");
+	joinedAlternatives.clear();
+
+	Expression* expression = parse.Parse(ParseJoined);
+
+	test.Check(parse.status == ParseStatus::Complete, name, "the parse did not complete");
+	test.Check(expression != nullptr, name, "there is no result");
+	test.Check(joinedAlternatives.size() == 1, name, "the forks were not merged");
+	test.Check(joinedAlternatives.size() == 1 && joinedAlternatives[0] == 0, name, "the preferred fork was not kept");
+	test.Check(parse.events.Count(ParseEventKind::Suspend_Join) == 2, name, "the forks did not both reach the join point");
+}
+
+void TestCommit(TestContext& test)
+{
+	const char* name = "commit";
+
+	TestParse parse("a b c");
+	lateAlternatives = 0;
+
+	Expression* expression = parse.Parse(ParseCommitted);
+
+	test.Check(parse.status == ParseStatus::Complete, name, "the parse did not complete");
+	test.Check(expression != nullptr && expression->Kind() == SyntaxKind::WordExpression
+		&& static_cast<WordExpression*>(expression)->nameToken == parse.tokenVector[0], name, "the committed alternative was not the result");
+	test.Check(lateAlternatives == 0, name, "a sibling ran after the commit");
+
+	//the first alternative and the third are terminated with the frames
+	//of the words parsed for the first
+	test.Check(parse.events.Count(ParseEventKind::TerminateFork) == 4, name, "the siblings were not terminated");
+	test.Check(parse.events.Count(ParseEventKind::DiscardFrame) == 2, name, "the pending frames were not discarded");
+}
+
+// index of the token of a word result, or -1.
+i32 WordIndex(const TestParse& parse, Expression* expression)
+{
+	if (expression == nullptr || expression->Kind() != SyntaxKind::WordExpression)
+		return -1;
+
+	Token* token = static_cast<WordExpression*>(expression)->nameToken;
+	for (size_t i = 0; i < parse.tokenVector.size(); ++i)
+	{
+		if (parse.tokenVector[i] == token)
+			return (i32)i;
+	}
+	return -1;
+}
+
+void TestStepBudget(TestContext& test)
+{
+	const char* name = "step budget";
+
+	TestParse parse("a b c d");
+	parse.options.budget.maxSteps = 3;
+
+	Expression* expression = parse.Parse(ParseAmbiguous, 4);
+
+	test.Check(parse.status == ParseStatus::StepBudgetExceeded, name, "the budget was not reported");
+	test.Check(expression == nullptr, name, "there is a result");
+	test.Check(parse.events.Count(ParseEventKind::Resume) == 3, name, "the parse did not stop at the budget");
+}
+
+void TestFrameBudget(TestContext& test)
+{
+	const char* name = "frame budget";
+
+	TestParse parse("a b c d");
+	parse.options.budget.maxLiveFrames = 2;
+
+	Expression* expression = parse.Parse(ParseAmbiguous, 4);
+
+	test.Check(parse.status == ParseStatus::FrameBudgetExceeded, name, "the budget was not reported");
+	test.Check(expression == nullptr, name, "there is a result");
+}
+
+void TestCancellation(TestContext& test)
+{
+	const char* name = "cancellation";
+
+	CancellationToken cancellation;
+	cancellation.Cancel();
+
+	TestParse parse("a b c d");
+	parse.options.cancellation = &cancellation;
+
+	Expression* expression = parse.Parse(ParseAmbiguous, 4);
+
+	test.Check(parse.status == ParseStatus::Cancelled, name, "the cancellation was not reported");
+	test.Check(expression == nullptr, name, "there is a result");
+	test.Check(parse.events.Count(ParseEventKind::Resume) == 0, name, "a fork ran after the cancellation");
+}
+
+void TestSession(TestContext& test)
+{
+	const char* name = "session";
+
+	TestParse whole("a b c d");
+	Expression* expected = whole.Parse(ParseAmbiguous, 4);
+
+	TestParse parse("a b c d");
+	Private::ParserCore::Session session = parse.Start(ParseAmbiguous, 4);
+
+	u64 slices = 1;
+	while (!session.Step(1))
+		++slices;
+
+	test.Check(session.GetStatus() == ParseStatus::Complete, name, "the parse did not complete");
+	test.Check(session.GetResult() != nullptr, name, "there is no result");
+	i32 expectedIndex = WordIndex(whole, expected);
+	test.Check(expectedIndex != -1 && expectedIndex == WordIndex(parse, static_cast<Expression*>(session.GetResult())), name, "the result differs from a parse in one slice");
+	test.Check(slices == whole.events.Count(ParseEventKind::Resume), name, "the slices did not add up to the steps of a parse in one slice");
+}
+
+void TestSessionCancellation(TestContext& test)
+{
+	const char* name = "session cancellation";
+
+	CancellationToken cancellation;
+
+	TestParse parse("a b c d");
+	parse.options.cancellation = &cancellation;
+
+	Private::ParserCore::Session session = parse.Start(ParseAmbiguous, 4);
+	test.Check(!session.Step(2), name, "the parse finished too early for the test");
+
+	cancellation.Cancel();
+	u64 resumed = parse.events.Count(ParseEventKind::Resume);
+
+	test.Check(session.Step(1), name, "the parse did not finish on cancellation");
+	test.Check(session.GetStatus() == ParseStatus::Cancelled, name, "the cancellation was not reported");
+	test.Check(session.GetResult() == nullptr, name, "there is a result");
+	test.Check(parse.events.Count(ParseEventKind::Resume) == resumed, name, "a fork ran after the cancellation");
+	test.Check(parse.events.Count(ParseEventKind::TerminateFork) > 0, name, "the pending forks were not terminated");
+}
+
+void TestSessionDestruction(TestContext& test)
+{
+	const char* name = "session destruction";
+
+	TestParse parse("a b c d");
+
+	{
+		Private::ParserCore::Session session = parse.Start(ParseAmbiguous, 4);
+		test.Check(!session.Step(2), name, "the parse finished too early for the test");
+		test.Check(parse.events.Count(ParseEventKind::TerminateFork) == 0, name, "a fork was terminated before the session was destroyed");
+	}
+
+	//the unfinished parse is cancelled, which terminates its pending forks
+	test.Check(parse.events.Count(ParseEventKind::TerminateFork) > 0, name, "the pending forks were not terminated");
+	test.Check(parse.events.Count(ParseEventKind::DiscardFrame) > 0, name, "the pending frames were not discarded");
+}
+
+void TestForksPerFrame(TestContext& test)
+{
+	const char* name = "forks per frame";
+
+	TestParse parse("a b c d");
+	parse.options.maxForksPerFrame = 1;
+
+	Expression* expression = parse.Parse(ParseAmbiguous, 4);
+
+	//only the preferred alternative of each frame is kept, which still accepts the input.
+	//the frames are the root and the chain of words parsed for its first alternative
+	test.Check(parse.status == ParseStatus::Truncated, name, "the truncation was not reported");
+	test.Check(expression != nullptr, name, "there is no result");
+	test.Check(parse.events.Count(ParseEventKind::TerminateFork) == parse.events.Count(ParseEventKind::Suspend_Fork), name, "the less preferred alternatives were not dropped");
+	test.Check(parse.events.Count(ParseEventKind::CreateFrame) == 5, name, "a dropped alternative created a frame");
+}
+
+} // namespace
+
+bool RunEngineTests(std::ostream& os)
+{
+	TestContext test(os);
+
+	TestCommit(test);
+	TestJoin(test);
+	TestStepBudget(test);
+	TestFrameBudget(test);
+	TestCancellation(test);
+	TestSession(test);
+	TestSessionCancellation(test);
+	TestSessionDestruction(test);
+	TestForksPerFrame(test);
+
+	return test.Success();
+}
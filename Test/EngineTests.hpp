@@ -0,0 +1,8 @@
+#pragma once
+
+#include <ostream>
+
+// Runs tests of the engine operations, limits and sessions on small grammars
+// of their own. Reports each failed check to os.
+// Returns whether all checks passed.
+bool RunEngineTests(std::ostream& os);
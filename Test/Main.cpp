@@ -1,18 +1,218 @@
+#include "Benchmark.hpp"
+#include "EngineTests.hpp"
 #include "Print.hpp"
 
+#include "HotspotProfiler.hpp"
+#include "Lexer.hpp"
 #include "Parser.hpp"
+#include "ParseTracer.hpp"
+#include "ReplayLog.hpp"
+#include "RuleProfiler.hpp"
 
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 using namespace CoroGLL;
 using namespace CoroGLL::Ast;
 
+namespace {
+
+class ObserverList final : public ParseObserver
+{
+public:
+	void Add(ParseObserver* observer)
+	{
+		m_observers.push_back(observer);
+	}
+
+	bool IsEmpty() const
+	{
+		return m_observers.empty();
+	}
+
+	virtual void OnEvent(const ParseEvent& event) override
+	{
+		for (ParseObserver* observer : m_observers)
+			observer->OnEvent(event);
+	}
+
+private:
+	std::vector<ParseObserver*> m_observers;
+};
+
+} // namespace
+
+// Parses an expression from standard input and prints its tree.
+//   --trace <file>   writes the scheduler activity as a Chrome trace.
+//   --profile        prints the cost of each grammar rule.
+//   --hotspots       prints the tokens at which the most work was done.
+//   --record <file>  writes an anonymized replay log of the parse.
+//   --replay <file>  replays a log instead of parsing standard input.
+//   --quiet          does not print the tree.
+//   --bench <path>   parses a file, or each file in a directory, repeatedly instead
+//                    of standard input, reporting throughput and latency percentiles.
+//                    may be repeated.
+//   --bench-list <file>
+//                    benchmarks the paths listed in a file, one per line.
+//   --warmup <n>     untimed parses of each benchmarked file, 1 by default.
+//   --iterations <n> timed parses of each benchmarked file, 10 by default.
+//   --engine-tests   runs the engine tests instead, failing if any check fails.
 int main(int argc, char** argv)
 {
-	std::string source = { std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>{} };
+	const char* tracePath = nullptr;
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	bool profile = false;
+	bool hotspots = false;
+	bool quiet = false;
+
+	std::vector<std::string> benchPaths;
+	BenchmarkOptions benchmarkOptions;
+
+	for (int index = 1; index < argc; ++index)
+	{
+		std::string_view arg = argv[index];
+
+		if (arg == "--engine-tests")
+			return RunEngineTests(std::cerr) ? 0 : 1;
+		else if (arg == "--trace" && index + 1 < argc)
+			tracePath = argv[++index];
+		else if (arg == "--profile")
+			profile = true;
+		else if (arg == "--hotspots")
+			hotspots = true;
+		else if (arg == "--record" && index + 1 < argc)
+			recordPath = argv[++index];
+		else if (arg == "--replay" && index + 1 < argc)
+			replayPath = argv[++index];
+		else if (arg == "--quiet")
+			quiet = true;
+		else if (arg == "--bench" && index + 1 < argc)
+			benchPaths.push_back(argv[++index]);
+		else if (arg == "--bench-list" && index + 1 < argc)
+		{
+			std::ifstream file(argv[++index]);
+			if (!file)
+			{
+				std::cerr << "cannot open " << argv[index] << '\n';
+				return 1;
+			}
+
+			for (std::string line; std::getline(file, line);)
+			{
+				if (!line.empty())
+					benchPaths.push_back(std::move(line));
+			}
+		}
+		else if (arg == "--warmup" && index + 1 < argc)
+			benchmarkOptions.warmup = std::atoi(argv[++index]);
+		else if (arg == "--iterations" && index + 1 < argc)
+			benchmarkOptions.iterations = std::atoi(argv[++index]);
+		else
+		{
+			std::cerr << "unknown argument " << arg << '\n';
+			return 1;
+		}
+	}
+
+	if (replayPath != nullptr && (hotspots || recordPath != nullptr))
+	{
+		std::cerr << "--replay has no source for --hotspots or --record\n";
+		return 1;
+	}
+
+	bool bench = !benchPaths.empty();
+	if (bench && (replayPath != nullptr || hotspots || recordPath != nullptr))
+	{
+		std::cerr << "--bench cannot be combined with --replay, --hotspots or --record\n";
+		return 1;
+	}
+
+	ParseOptions options;
+	ObserverList observers;
+
+	ParseTracer tracer;
+	if (tracePath != nullptr)
+		observers.Add(&tracer);
+
+	RuleProfiler profiler;
+	if (profile)
+		observers.Add(&profiler);
+
+	HotspotProfiler hotspotProfiler;
+	if (hotspots)
+		observers.Add(&hotspotProfiler);
+
+	if (!observers.IsEmpty())
+		options.observer = &observers;
+
+	std::string source;
+
+	if (bench)
+	{
+		std::vector<std::string> files;
+		if (!CollectFiles(benchPaths, &files) || !RunBenchmark(std::cout, files, benchmarkOptions, options))
+			return 1;
+	}
+	else if (replayPath != nullptr)
+	{
+		std::ifstream file(replayPath, std::ios::binary);
+
+		ReplayLog log;
+		if (!log.Read(file))
+		{
+			std::cerr << "cannot read replay log " << replayPath << '\n';
+			return 1;
+		}
+
+		u64 divergence;
+		if (ReplayExpression(log, options, &divergence))
+			std::cout << "replay matched " << log.events.size() << " events\n";
+		else std::cout << "replay diverged at event " << divergence << " of " << log.events.size() << '\n';
+	}
+	else
+	{
+		source.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>{});
+
+		ReplayLog log;
+		SyntaxTree tree = recordPath != nullptr
+			? RecordExpression(source, options, &log)
+			: ParseExpression(source, options);
+
+		if (!quiet)
+		{
+			//the input was rejected or the parse was abandoned
+			if (tree.GetRoot() == nullptr)
+				std::cout << "no tree\n";
+			else Print(std::cout, tree.GetRoot());
+		}
+
+		if (recordPath != nullptr)
+		{
+			std::ofstream file(recordPath, std::ios::binary);
+			log.Write(file);
+		}
+	}
+
+	if (profile)
+	{
+		std::cout << '\n';
+		profiler.WriteReport(std::cout);
+	}
+
+	if (hotspots)
+	{
+		std::cout << '\n';
+		hotspotProfiler.WriteReport(std::cout, source, Lex(source));
+	}
 
-	SyntaxTree tree = ParseExpression(source);
-	Print(std::cout, tree.GetRoot());
+	if (tracePath != nullptr)
+	{
+		std::ofstream file(tracePath);
+		tracer.WriteChromeTrace(file);
+	}
 }